@@ -22,6 +22,7 @@
 #include "./src/app/AppLog.h"
 #include "./src/app/thread/QueueMain.h"
 #include "./src/app/thread/ThreadGame.h"
+#include "./src/app/peripheral/PowerManager.h"
 
 /////////////////////////////////////////////////////////////////////////////
 static AppContext appContext = {0};
@@ -34,7 +35,9 @@ static void createTasks(void)
 {
     static freertos::QueueMain queueMain;
     static freertos::ThreadGame threadGame;
+    static PowerManager powerManager;
 
+    appContext.powerManager = &powerManager;
     appContext.queueMain = &queueMain;
     appContext.threadGame = &threadGame;
 
@@ -0,0 +1,136 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// host stand-in of ArduProf (included by src/app/ArduProfFreeRTOS.h): Message, print macros,
+// MessageQueue, MessageBus, ThreadBase and SoftwareTimer over the host FreeRTOS stand-in
+/////////////////////////////////////////////////////////////////////////////
+#include <Arduino.h>
+#include <DebugLog.h>
+
+#define PRINT(...) Serial.print(__VA_ARGS__)
+#define PRINTLN(...) Serial.println(__VA_ARGS__)
+
+typedef struct _Message
+{
+    int16_t event;
+    int16_t iParam;
+    uint16_t uParam;
+    uint32_t lParam;
+} Message;
+
+#define __EVENT_FUNC_DECLARATION(event) void handler##event(const Message &msg);
+#define __EVENT_FUNC_DEFINITION(cls, event, msg) void cls::handler##event(const Message &msg)
+
+namespace ardufreertos
+{
+    class MessageQueue
+    {
+    public:
+        MessageQueue(QueueHandle_t queue = nullptr) : _queue(queue), _context(nullptr) {}
+        // a queue of length messages in static storage
+        MessageQueue(uint16_t length, uint8_t *storage, StaticQueue_t *queueBuffer)
+            : _queue(xQueueCreateStatic(length, sizeof(Message), storage, queueBuffer)), _context(nullptr) {}
+        virtual ~MessageQueue() = default;
+
+        QueueHandle_t queue(void)
+        {
+            return _queue;
+        }
+        void *context(void)
+        {
+            return _context;
+        }
+
+        bool postEvent(int16_t event, int16_t iParam = 0, uint16_t uParam = 0, uint32_t lParam = 0);
+        bool postEvent(MessageQueue *target, int16_t event, int16_t iParam = 0, uint16_t uParam = 0, uint32_t lParam = 0);
+        bool sendMessageToTask(int16_t event, int16_t iParam = 0, uint16_t uParam = 0, uint32_t lParam = 0);
+        bool sendMessageFromIsrToTask(int16_t event, int16_t iParam = 0, uint16_t uParam = 0, uint32_t lParam = 0);
+
+        virtual void onMessage(const Message &) {}
+
+    protected:
+        QueueHandle_t _queue;
+        void *_context; // given to start()
+    };
+
+    // message loop run by the calling task, e.g. the Arduino loop task
+    class MessageBus : public MessageQueue
+    {
+    public:
+        using MessageQueue::MessageQueue;
+
+        virtual void start(void *ctx)
+        {
+            _context = ctx;
+        }
+        // handles the messages received within ms
+        void messageLoop(uint32_t ms);
+        void messageLoopForever(void);
+    };
+
+    // message loop of a task created by the derived class, which calls run() from it
+    class ThreadBase : public MessageQueue
+    {
+    public:
+        using MessageQueue::MessageQueue;
+
+        virtual void start(void *ctx)
+        {
+            _context = ctx;
+        }
+
+    protected:
+        TaskHandle_t _taskHandle = nullptr;
+
+        virtual void setup(void) {}
+        virtual void delayInit(void) {}
+        // setup(), delayInit(), then onMessage() for each message, forever
+        virtual void run(void);
+    };
+
+    class SoftwareTimer
+    {
+    public:
+        SoftwareTimer(const char *name, TickType_t period, UBaseType_t autoReload, void *timerId, TimerCallbackFunction_t callback);
+        virtual ~SoftwareTimer() = default;
+
+        bool start(void);
+        bool stop(void);
+        bool isActive(void);
+        bool changePeriod(TickType_t period);
+
+        TimerHandle_t timer(void)
+        {
+            return _timer;
+        }
+
+    protected:
+        TimerHandle_t _timer;
+    };
+
+    class PeriodicTimer : public SoftwareTimer
+    {
+    public:
+        PeriodicTimer(const char *name, TickType_t period, TimerCallbackFunction_t callback)
+            : SoftwareTimer(name, period, pdTRUE, nullptr, callback) {}
+    };
+}
@@ -0,0 +1,186 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// host stand-in of the Arduino core of an ESP32-C3: simulated time (see HostSim.h), GPIO levels from a
+// table set by the test (hostSetPinLevel) which raises the attached interrupts, Serial writes to stdout
+// or to the sink of the test
+/////////////////////////////////////////////////////////////////////////////
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include "./HostFreeRTOS.h"
+#include "./esp_err.h"
+#include "./esp_system.h"
+#include "./esp_timer.h"
+#include "./driver/gpio.h"
+
+#define CONFIG_IDF_TARGET_ESP32C3 1
+
+#define LOW 0x0
+#define HIGH 0x1
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define IRAM_ATTR
+
+// defined by the sketch
+void setup(void);
+void loop(void);
+
+// as the Arduino core: setup() then loop() forever, in "loopTask" at priority 1
+void hostArduinoStart(void (*setup)(void), void (*loop)(void));
+
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+#define digitalPinToInterrupt(pin) (pin)
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+// level returned by digitalRead(pin) from now on, an edge runs the interrupt handler attached to the pin
+// and a level armed by gpio_wakeup_enable() ends light sleep
+void hostSetPinLevel(uint8_t pin, uint8_t value);
+
+uint32_t getCpuFrequencyMhz(void);
+
+class EspClass
+{
+public:
+    const char *getChipModel(void)
+    {
+        return "ESP32-C3 (host)";
+    }
+    uint8_t getChipRevision(void)
+    {
+        return 4;
+    }
+    uint8_t getChipCores(void)
+    {
+        return 1;
+    }
+    const char *getSdkVersion(void)
+    {
+        return "host";
+    }
+    uint32_t getCpuFreqMHz(void)
+    {
+        return getCpuFrequencyMhz();
+    }
+    // host clock at the nominal CPU frequency: code runs on the host CPU, not in simulated time
+    uint32_t getCycleCount(void);
+    uint32_t getFreeHeap(void)
+    {
+        return xPortGetFreeHeapSize();
+    }
+};
+
+extern EspClass ESP;
+
+// bytes written to Serial, text and binary
+typedef std::function<void(const uint8_t *data, size_t size)> HostSerialSink;
+
+class HostSerial
+{
+public:
+    void begin(unsigned long) {}
+    operator bool() const
+    {
+        return true;
+    }
+
+    template <typename... Args>
+    void print(const Args &...args)
+    {
+        std::ostringstream text;
+        (printValue(text, args), ...);
+        writeText(text.str());
+    }
+    template <typename... Args>
+    void println(const Args &...args)
+    {
+        std::ostringstream text;
+        (printValue(text, args), ...);
+        text << '\n';
+        writeText(text.str());
+    }
+
+    size_t write(const uint8_t *data, size_t size);
+    size_t write(uint8_t value)
+    {
+        return write(&value, 1);
+    }
+
+    // the test receives what is written instead of stdout, nullptr: back to stdout
+    void hostSetSink(HostSerialSink sink)
+    {
+        _sink = sink;
+    }
+
+private:
+    void writeText(const std::string &text)
+    {
+        write((const uint8_t *)text.data(), text.size());
+    }
+
+    // as on target, 8-bit integers and enums print as numbers
+    static void printValue(std::ostream &out, uint8_t value)
+    {
+        out << (unsigned)value;
+    }
+    static void printValue(std::ostream &out, int8_t value)
+    {
+        out << (int)value;
+    }
+    template <typename T>
+    static void printValue(std::ostream &out, const T &value)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            out << (long)value;
+        }
+        else
+        {
+            out << value;
+        }
+    }
+
+    HostSerialSink _sink;
+};
+
+extern HostSerial Serial;
@@ -0,0 +1,76 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// host stand-in of DebugLog: LOG_xxx print to stderr up to the level of LOG_SET_LEVEL(), which is capped by
+// hostLogSetMaxLevel() so a test keeps the log of the sketch quiet
+/////////////////////////////////////////////////////////////////////////////
+#include <iostream>
+
+namespace DebugLogLevel
+{
+    enum Level
+    {
+        LVL_NONE = 0,
+        LVL_ERROR,
+        LVL_WARN,
+        LVL_INFO,
+        LVL_DEBUG,
+        LVL_TRACE,
+    };
+}
+
+typedef struct _HostLogLevel
+{
+    int level = DebugLogLevel::LVL_TRACE;
+    int maxLevel = DebugLogLevel::LVL_TRACE;
+} HostLogLevel;
+
+inline HostLogLevel &hostLogLevel(void)
+{
+    static HostLogLevel level;
+    return level;
+}
+
+static inline void hostLogSetMaxLevel(int maxLevel)
+{
+    hostLogLevel().maxLevel = maxLevel;
+}
+
+template <typename... Args>
+static inline void hostLog(int level, const char *name, const Args &...args)
+{
+    if (level <= hostLogLevel().level && level <= hostLogLevel().maxLevel)
+    {
+        std::cerr << "[" << name << "] ";
+        (std::cerr << ... << args) << '\n';
+    }
+}
+
+#define LOG_ERROR(...) hostLog(DebugLogLevel::LVL_ERROR, "ERROR", __VA_ARGS__)
+#define LOG_WARN(...) hostLog(DebugLogLevel::LVL_WARN, "WARN", __VA_ARGS__)
+#define LOG_INFO(...) hostLog(DebugLogLevel::LVL_INFO, "INFO", __VA_ARGS__)
+#define LOG_DEBUG(...) hostLog(DebugLogLevel::LVL_DEBUG, "DEBUG", __VA_ARGS__)
+#define LOG_TRACE(...) hostLog(DebugLogLevel::LVL_TRACE, "TRACE", __VA_ARGS__)
+
+#define LOG_SET_LEVEL(logLevel) (hostLogLevel().level = (logLevel))
+#define LOG_SET_DELIMITER(delimiter) ((void)0)
+#define LOG_ATTACH_SERIAL(serial) ((void)0)
@@ -0,0 +1,125 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// host stand-in of FastLED: CRGB and a sink for the frames sent by FastLED.show()
+// show() blocks the calling task for the WS2812 transmission of the frame in simulated time (see HostSim.h):
+// 24 bits at 800 kHz per led, then the reset (latch) time. the test sees each frame once latched
+/////////////////////////////////////////////////////////////////////////////
+#include <functional>
+#include <Arduino.h>
+
+#define HOST_WS2812_US_PER_LED 30
+#define HOST_WS2812_RESET_US 50
+
+struct CRGB
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+
+    // named colours used by the app, values of FastLED
+    enum HTMLColorCode : uint32_t
+    {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Cyan = 0x00FFFF,
+        Green = 0x008000,
+        Magenta = 0xFF00FF,
+        OrangeRed = 0xFF4500,
+        Purple = 0x800080,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+        Yellow = 0xFFFF00,
+    };
+
+    CRGB() = default;
+    constexpr CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    constexpr CRGB(uint32_t colorCode) : r((uint8_t)(colorCode >> 16)), g((uint8_t)(colorCode >> 8)), b((uint8_t)colorCode) {}
+};
+
+// clockless chipsets: the colour order is not modelled, frames are seen as RGB
+enum
+{
+    NEOPIXEL,
+    WS2812,
+    WS2812B,
+};
+
+class CLEDController
+{
+public:
+    CRGB *leds(void)
+    {
+        return _leds;
+    }
+    int size(void)
+    {
+        return _numLeds;
+    }
+    CLEDController &setLeds(CRGB *leds, int numLeds)
+    {
+        _leds = leds;
+        _numLeds = numLeds;
+        return *this;
+    }
+
+private:
+    CRGB *_leds = nullptr;
+    int _numLeds = 0;
+};
+
+// leds: the frame as latched by the leds, timeShown: hostSimTime() at the end of the reset time
+typedef std::function<void(const CRGB *leds, int numLeds, int64_t timeShown)> HostLedSink;
+
+class CFastLED
+{
+public:
+    template <int Chipset, uint8_t DataPin>
+    CLEDController &addLeds(CRGB *leds, int numLeds)
+    {
+        return _controller.setLeds(leds, numLeds);
+    }
+
+    void setBrightness(uint8_t brightness)
+    {
+        _brightness = brightness;
+    }
+    void show(void);
+
+    // host: called for every frame shown, replaces the previous sink
+    void hostSetSink(HostLedSink sink)
+    {
+        _sink = sink;
+    }
+    uint32_t hostGetFramesShown(void) const
+    {
+        return _framesShown;
+    }
+
+private:
+    CLEDController _controller;
+    uint8_t _brightness = 255;
+    HostLedSink _sink;
+    uint32_t _framesShown = 0;
+};
+
+extern CFastLED FastLED;
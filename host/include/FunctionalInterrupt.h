@@ -18,12 +18,7 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #pragma once
+#include <functional>
+#include <Arduino.h>
 
-typedef enum _TimeSlotState
-{
-    SlotGame = 0,
-    SlotPlayer1,
-    SlotPlayer2,
-    SlotIdle,
-    SlotMaxValue,
-} TimeSlotState;
\ No newline at end of file
+void attachInterrupt(uint8_t pin, std::function<void(void)> handler, int mode);
@@ -0,0 +1,110 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// host stand-in of the FreeRTOS API used by the app, over a simulated-time scheduler (see HostSim.h)
+// tasks are coroutines on one host thread: the highest priority ready task runs until it blocks in a
+// queue, a notification or a delay, a task made ready at a higher priority preempts at that call.
+// time does not pass while a task runs, it jumps to the next timer expiry or timeout once all tasks
+// are blocked. timers fire in expiry order from the timer service; called outside of a task, the
+// blocking calls return at once
+/////////////////////////////////////////////////////////////////////////////
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint8_t StackType_t;
+
+typedef struct _HostQueue *QueueHandle_t;
+typedef struct _HostTimer *TimerHandle_t;
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t xTimer);
+
+typedef struct _StaticQueue_t
+{
+    void *reserved;
+} StaticQueue_t;
+
+typedef struct _StaticTask_t
+{
+    void *reserved;
+} StaticTask_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configMINIMAL_STACK_SIZE 768
+#define tskIDLE_PRIORITY 0
+#define ARDUINO_RUNNING_CORE 0
+
+#define portYIELD_FROM_ISR(...) ((void)0)
+
+// one core, one host thread: critical sections have nothing to exclude
+typedef struct _portMUX_TYPE
+{
+    uint32_t owner;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t task, const char *name, uint32_t stackDepth, void *parameter,
+                                           UBaseType_t priority, StackType_t *stack, StaticTask_t *taskBuffer, BaseType_t coreId);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+void vTaskPrioritySet(TaskHandle_t task, UBaseType_t priority);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+// free stack in bytes against the stack depth the task was created with, as used on the host
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken);
+BaseType_t xPortInIsrContext(void);
+BaseType_t xPortGetCoreID(void);
+size_t xPortGetFreeHeapSize(void);
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t *storage, StaticQueue_t *queueBuffer);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticksToWait);
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *higherPriorityTaskWoken);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticksToWait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t autoReload, void *timerId, TimerCallbackFunction_t callback);
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticksToWait);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticksToWait);
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticksToWait);
+BaseType_t xTimerStartFromISR(TimerHandle_t timer, BaseType_t *higherPriorityTaskWoken);
+BaseType_t xTimerStopFromISR(TimerHandle_t timer, BaseType_t *higherPriorityTaskWoken);
+BaseType_t xTimerChangePeriodFromISR(TimerHandle_t timer, TickType_t period, BaseType_t *higherPriorityTaskWoken);
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer);
+TickType_t xTimerGetPeriod(TimerHandle_t timer);
+void *pvTimerGetTimerID(TimerHandle_t timer);
@@ -0,0 +1,48 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// control of the simulated target, for tests and benchmarks only
+//
+// simulated time starts at 0 and advances only in hostSimRun(): code costs no time, the I/O modelled by
+// the stand-ins does (FastLED.show() blocks its task for the WS2812 transmission, see FastLED.h).
+// call the hostXxx functions between two hostSimRun(), from the test, not from a task:
+// hostSetPinLevel() (Arduino.h) raises the interrupt attached to the pin at once, at the current time
+/////////////////////////////////////////////////////////////////////////////
+#include <stdint.h>
+#include "./HostFreeRTOS.h"
+
+// runs the ready tasks, and the timers and timeouts falling due, until us of simulated time have passed
+void hostSimRun(uint32_t us);
+
+// simulated time in us, esp_timer_get_time() on the host
+int64_t hostSimTime(void);
+
+// the queue the task receives its messages from, nullptr until it has received from one,
+// e.g. "loopTask" (QueueMain) or "ThreadGame"
+QueueHandle_t hostTaskGetQueue(const char *taskName);
+
+// highest number of messages waiting in the queue, and sends rejected because it was full
+UBaseType_t hostQueueGetPeak(QueueHandle_t queue);
+uint32_t hostQueueGetRejected(QueueHandle_t queue);
+
+// operator new calls of the process since it started, freed or not (heap_caps_get_info() counts the live blocks)
+uint32_t hostHeapGetAllocations(void);
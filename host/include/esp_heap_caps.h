@@ -18,33 +18,21 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #pragma once
-#include "./button/DebounceButton.h"
-#include "../pins.h"
+#include <stddef.h>
+#include <stdint.h>
 
-#ifdef GPIO_BUTTON
-#undef GPIO_BUTTON
-#endif
+#define MALLOC_CAP_DEFAULT (1 << 12)
 
-/////////////////////////////////////////////////////////////
-// ButtonOnOff = ButtonBoot
-/////////////////////////////////////////////////////////////
-#define GPIO_BUTTON PIN_SW_PLAYER2
-#define BUTTON_STATE_ACTIVE LOW
-
-class ButtonPlayer2 : public DebounceButton
+typedef struct
 {
-public:
-    ButtonPlayer2(QueueHandle_t queue) : DebounceButton(GPIO_BUTTON, BUTTON_STATE_ACTIVE, INPUT_PULLUP, queue)
-    {
-        enableInterrupt(CHANGE);
-    }
-
-    ~ButtonPlayer2()
-    {
-        disableInterrupt();
-    }
-
-    uint32_t edgeFallingTime;
-};
+    size_t total_free_bytes;
+    size_t total_allocated_bytes;
+    size_t largest_free_block;
+    size_t minimum_free_bytes;
+    size_t allocated_blocks;
+    size_t free_blocks;
+    size_t total_blocks;
+} multi_heap_info_t;
 
-#undef GPIO_BUTTON
+// blocks and bytes allocated by operator new on the host, against a heap of the size of the target's
+void heap_caps_get_info(multi_heap_info_t *info, uint32_t caps);
@@ -0,0 +1,111 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <ArduProf.h>
+
+namespace ardufreertos
+{
+    bool MessageQueue::postEvent(int16_t event, int16_t iParam, uint16_t uParam, uint32_t lParam)
+    {
+        return postEvent(this, event, iParam, uParam, lParam);
+    }
+
+    bool MessageQueue::postEvent(MessageQueue *target, int16_t event, int16_t iParam, uint16_t uParam, uint32_t lParam)
+    {
+        if (target == nullptr || target->_queue == nullptr)
+        {
+            return false;
+        }
+        Message msg = {event, iParam, uParam, lParam};
+        return xQueueSend(target->_queue, &msg, 0) == pdPASS;
+    }
+
+    bool MessageQueue::sendMessageToTask(int16_t event, int16_t iParam, uint16_t uParam, uint32_t lParam)
+    {
+        return postEvent(this, event, iParam, uParam, lParam);
+    }
+
+    bool MessageQueue::sendMessageFromIsrToTask(int16_t event, int16_t iParam, uint16_t uParam, uint32_t lParam)
+    {
+        if (_queue == nullptr)
+        {
+            return false;
+        }
+        Message msg = {event, iParam, uParam, lParam};
+        return xQueueSendFromISR(_queue, &msg, nullptr) == pdPASS;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////
+    void MessageBus::messageLoop(uint32_t ms)
+    {
+        Message msg;
+        if (xQueueReceive(_queue, &msg, pdMS_TO_TICKS(ms)) == pdPASS)
+        {
+            onMessage(msg);
+        }
+    }
+
+    void MessageBus::messageLoopForever(void)
+    {
+        for (;;)
+        {
+            messageLoop(portMAX_DELAY);
+        }
+    }
+
+    void ThreadBase::run(void)
+    {
+        setup();
+        delayInit();
+        Message msg;
+        for (;;)
+        {
+            if (xQueueReceive(_queue, &msg, portMAX_DELAY) == pdPASS)
+            {
+                onMessage(msg);
+            }
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////
+    SoftwareTimer::SoftwareTimer(const char *name, TickType_t period, UBaseType_t autoReload, void *timerId, TimerCallbackFunction_t callback)
+        : _timer(xTimerCreate(name, period, autoReload, timerId, callback))
+    {
+    }
+
+    bool SoftwareTimer::start(void)
+    {
+        return xTimerStart(_timer, 0) == pdPASS;
+    }
+
+    bool SoftwareTimer::stop(void)
+    {
+        return xTimerStop(_timer, 0) == pdPASS;
+    }
+
+    bool SoftwareTimer::isActive(void)
+    {
+        return xTimerIsTimerActive(_timer) == pdTRUE;
+    }
+
+    bool SoftwareTimer::changePeriod(TickType_t period)
+    {
+        return xTimerChangePeriod(_timer, period, 0) == pdPASS;
+    }
+}
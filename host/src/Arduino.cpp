@@ -0,0 +1,274 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <chrono>
+#include <functional>
+#include <Arduino.h>
+#include <FunctionalInterrupt.h>
+#include <HostSim.h>
+#include <esp_sleep.h>
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+#include "./HostScheduler.h"
+
+#define HOST_NUM_PINS 64
+#define HOST_CPU_FREQ_MHZ 160
+#define HOST_LOOP_TASK_STACK_SIZE 8192
+#define HOST_LOOP_TASK_PRIORITY 1
+
+typedef struct _HostPin
+{
+    uint8_t level;
+    std::function<void(void)> handler; // attached interrupt, empty if none
+    int mode;                          // RISING, FALLING or CHANGE
+    bool isIntrEnabled;
+    gpio_int_type_t wakeupLevel; // GPIO_INTR_DISABLE if the pin does not wake the chip up
+} HostPin;
+
+HostSerial Serial;
+EspClass ESP;
+
+static HostPin pins[HOST_NUM_PINS];
+static bool isGpioWakeupEnabled = false;
+
+size_t HostSerial::write(const uint8_t *data, size_t size)
+{
+    if (_sink)
+    {
+        _sink(data, size);
+    }
+    else
+    {
+        std::cout.write((const char *)data, size);
+    }
+    return size;
+}
+
+static void (*sketchSetup)(void) = nullptr;
+static void (*sketchLoop)(void) = nullptr;
+
+void hostArduinoStart(void (*setup)(void), void (*loop)(void))
+{
+    sketchSetup = setup;
+    sketchLoop = loop;
+    xTaskCreateStaticPinnedToCore(
+        [](void *)
+        {
+            sketchSetup();
+            for (;;)
+            {
+                sketchLoop();
+            }
+        },
+        "loopTask", HOST_LOOP_TASK_STACK_SIZE, nullptr, HOST_LOOP_TASK_PRIORITY, nullptr, nullptr, ARDUINO_RUNNING_CORE);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return hostSimTime();
+}
+
+uint32_t millis(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+uint32_t micros(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+void delay(uint32_t ms)
+{
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+// a busy wait: the caller keeps the CPU while the time passes
+void delayMicroseconds(uint32_t us)
+{
+    hostBusyWaitUs(us);
+}
+
+uint32_t getCpuFrequencyMhz(void)
+{
+    return HOST_CPU_FREQ_MHZ;
+}
+
+uint32_t EspClass::getCycleCount(void)
+{
+    static const std::chrono::steady_clock::time_point timeStart = std::chrono::steady_clock::now();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - timeStart).count();
+    return (uint32_t)(ns * HOST_CPU_FREQ_MHZ / 1000);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// GPIO
+/////////////////////////////////////////////////////////////////////////////
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < HOST_NUM_PINS && mode == INPUT_PULLUP)
+    {
+        pins[pin].level = HIGH;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return (pin < HOST_NUM_PINS) ? pins[pin].level : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    hostSetPinLevel(pin, value);
+}
+
+void attachInterrupt(uint8_t pin, std::function<void(void)> handler, int mode)
+{
+    if (pin < HOST_NUM_PINS)
+    {
+        pins[pin].handler = handler;
+        pins[pin].mode = mode;
+        pins[pin].isIntrEnabled = true;
+    }
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode)
+{
+    attachInterrupt(pin, std::function<void(void)>(handler), mode);
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    if (pin < HOST_NUM_PINS)
+    {
+        pins[pin].handler = nullptr;
+        pins[pin].isIntrEnabled = false;
+    }
+}
+
+static bool isWakeupLevel(const HostPin &pin)
+{
+    return (pin.wakeupLevel == GPIO_INTR_LOW_LEVEL && pin.level == LOW) ||
+           (pin.wakeupLevel == GPIO_INTR_HIGH_LEVEL && pin.level == HIGH);
+}
+
+void hostSetPinLevel(uint8_t pin, uint8_t value)
+{
+    if (pin >= HOST_NUM_PINS)
+    {
+        return;
+    }
+    HostPin &state = pins[pin];
+    uint8_t level = value ? HIGH : LOW;
+    if (level == state.level)
+    {
+        return;
+    }
+    state.level = level;
+
+    if (isGpioWakeupEnabled && hostIsAsleep() && isWakeupLevel(state))
+    {
+        hostSleepWake();
+    }
+    bool isEdge = (state.mode == CHANGE) || (state.mode == RISING && level == HIGH) || (state.mode == FALLING && level == LOW);
+    if (state.handler && state.isIntrEnabled && isEdge)
+    {
+        hostIsrEnter();
+        state.handler();
+        hostIsrExit();
+    }
+}
+
+uint32_t hostRegRead(uint32_t reg)
+{
+    uint32_t value = 0;
+    if (reg == GPIO_IN_REG)
+    {
+        for (uint8_t pin = 0; pin < 32; pin++)
+        {
+            value |= (uint32_t)pins[pin].level << pin;
+        }
+    }
+    return value;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t pin)
+{
+    if (pin >= HOST_NUM_PINS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pins[pin].isIntrEnabled = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t pin)
+{
+    if (pin >= HOST_NUM_PINS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pins[pin].isIntrEnabled = false;
+    return ESP_OK;
+}
+
+// the handler keeps its mode: wakeup levels are kept apart, see gpio_wakeup_enable()
+esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t)
+{
+    return (pin < HOST_NUM_PINS) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type)
+{
+    if (pin >= HOST_NUM_PINS || (type != GPIO_INTR_LOW_LEVEL && type != GPIO_INTR_HIGH_LEVEL))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pins[pin].wakeupLevel = type;
+    return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t pin)
+{
+    if (pin >= HOST_NUM_PINS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pins[pin].wakeupLevel = GPIO_INTR_DISABLE;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup(void)
+{
+    isGpioWakeupEnabled = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start(void)
+{
+    for (const HostPin &pin : pins)
+    {
+        if (isGpioWakeupEnabled && isWakeupLevel(pin))
+        {
+            return ESP_OK;
+        }
+    }
+    hostSleepEnter();
+    return ESP_OK;
+}
@@ -0,0 +1,115 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <malloc.h>
+#include <atomic>
+#include <new>
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_pm.h>
+#include <HostSim.h>
+
+#define HOST_HEAP_SIZE (320 * 1024) // heap of an ESP32-C3 running the app, roughly
+
+// every operator new of the process is counted, so heap_caps_get_info() reports the allocations of the app
+static std::atomic<size_t> allocatedBlocks(0);
+static std::atomic<size_t> allocatedBytes(0);
+static std::atomic<uint32_t> allocations(0); // every operator new, freed or not
+
+void *operator new(size_t size)
+{
+    void *block = malloc(size ? size : 1);
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    allocatedBlocks++;
+    allocations++;
+    allocatedBytes += malloc_usable_size(block);
+    return block;
+}
+
+void operator delete(void *block) noexcept
+{
+    if (block)
+    {
+        allocatedBlocks--;
+        allocatedBytes -= malloc_usable_size(block);
+        free(block);
+    }
+}
+
+void operator delete(void *block, size_t) noexcept
+{
+    operator delete(block);
+}
+
+uint32_t hostHeapGetAllocations(void)
+{
+    return allocations;
+}
+
+void heap_caps_get_info(multi_heap_info_t *info, uint32_t)
+{
+    size_t used = allocatedBytes;
+    memset(info, 0, sizeof(*info));
+    info->total_allocated_bytes = used;
+    info->total_free_bytes = (used < HOST_HEAP_SIZE) ? HOST_HEAP_SIZE - used : 0;
+    info->largest_free_block = info->total_free_bytes;
+    info->minimum_free_bytes = info->total_free_bytes;
+    info->allocated_blocks = allocatedBlocks;
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_DEFAULT);
+    return info.total_free_bytes;
+}
+
+esp_reset_reason_t esp_reset_reason(void)
+{
+    return ESP_RST_POWERON;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+static struct _HostPmLock
+{
+} pmLock;
+
+esp_err_t esp_pm_configure(const void *config)
+{
+    return config ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t, int, const char *, esp_pm_lock_handle_t *handle)
+{
+    *handle = &pmLock;
+    return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t handle)
+{
+    return handle ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t handle)
+{
+    return handle ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
@@ -0,0 +1,43 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <vector>
+#include <FastLED.h>
+#include <HostSim.h>
+#include "./HostScheduler.h"
+
+CFastLED FastLED;
+
+// the leds keep showing the previous frame until the new one is latched at the end of the transmission
+void CFastLED::show(void)
+{
+    int numLeds = _controller.size();
+    std::vector<CRGB> frame(_controller.leds(), _controller.leds() + numLeds);
+    for (CRGB &led : frame)
+    {
+        led = CRGB((uint8_t)(led.r * _brightness / 255), (uint8_t)(led.g * _brightness / 255), (uint8_t)(led.b * _brightness / 255));
+    }
+
+    hostTaskDelayUs(numLeds * HOST_WS2812_US_PER_LED + HOST_WS2812_RESET_US);
+    _framesShown++;
+    if (_sink)
+    {
+        _sink(frame.data(), numLeds, hostSimTime());
+    }
+}
@@ -0,0 +1,621 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <ucontext.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <Arduino.h>
+#include <HostSim.h>
+#include "./HostScheduler.h"
+
+// every task gets a host sized stack, the app's stack sizes are too small for host code
+#define HOST_TASK_STACK_SIZE (256 * 1024)
+#define HOST_STACK_FILL 0xA5
+#define HOST_TIME_NEVER INT64_MAX
+
+typedef enum _HostTaskState
+{
+    HostTaskReady = 0,
+    HostTaskRunning,
+    HostTaskBlocked,
+    HostTaskDeleted,
+} HostTaskState;
+
+typedef struct _HostTask
+{
+    const char *name;
+    TaskFunction_t function;
+    void *parameter;
+    UBaseType_t priority;
+    uint32_t stackDepth;
+    std::unique_ptr<uint8_t[]> stack;
+    ucontext_t context;
+    HostTaskState state;
+    uint64_t readyOrder;    // tasks of equal priority run in the order they became ready
+    int64_t timeWake;       // timeout of a blocked task, HOST_TIME_NEVER if none
+    const void *waitObject; // queue, task (notification) or nullptr (delay) a blocked task waits for
+    bool isTimedOut;
+    uint32_t notifyCount;
+} HostTask;
+
+typedef struct _HostQueue
+{
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t peak;
+    uint32_t rejected;
+    HostTask *receiver; // last task which received from the queue
+} HostQueue;
+
+typedef struct _HostTimer
+{
+    const char *name;
+    TickType_t period;
+    UBaseType_t autoReload;
+    void *timerId;
+    TimerCallbackFunction_t callback;
+    bool isActive;
+    int64_t timeExpiry;
+} HostTimer;
+
+static std::atomic<int64_t> timeNow(0); // read by the host threads of the plain logic tests too
+static std::vector<std::unique_ptr<HostTask>> tasks;
+static std::vector<HostTimer *> timers;
+static std::vector<HostQueue *> queues;
+static HostTask *taskCurrent = nullptr; // nullptr: the test, an interrupt or a timer callback runs
+static ucontext_t contextScheduler;
+static uint64_t readyOrder = 0;
+static uint32_t isrNesting = 0;
+static bool isAsleep = false;
+
+static int64_t ticksToUs(TickType_t ticks)
+{
+    return (int64_t)ticks * portTICK_PERIOD_MS * 1000;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// scheduler
+/////////////////////////////////////////////////////////////////////////////
+static HostTask *toTask(TaskHandle_t handle)
+{
+    return handle ? static_cast<HostTask *>(handle) : taskCurrent;
+}
+
+static void makeReady(HostTask *task)
+{
+    task->state = HostTaskReady;
+    task->readyOrder = ++readyOrder;
+    task->timeWake = HOST_TIME_NEVER;
+    task->waitObject = nullptr;
+}
+
+static HostTask *nextReadyTask(void)
+{
+    if (isAsleep)
+    {
+        return nullptr;
+    }
+    HostTask *next = nullptr;
+    for (std::unique_ptr<HostTask> &task : tasks)
+    {
+        if (task->state == HostTaskReady &&
+            (!next || task->priority > next->priority ||
+             (task->priority == next->priority && task->readyOrder < next->readyOrder)))
+        {
+            next = task.get();
+        }
+    }
+    return next;
+}
+
+// back to the scheduler loop in hostSimRun(), returns once the task runs again
+static void switchOut(HostTask *task)
+{
+    swapcontext(&task->context, &contextScheduler);
+}
+
+// a task made ready at a higher priority than the running one preempts it, never an interrupt
+static void preemptIfHigher(void)
+{
+    HostTask *next = nextReadyTask();
+    if (taskCurrent && isrNesting == 0 && next && next->priority > taskCurrent->priority)
+    {
+        HostTask *task = taskCurrent;
+        makeReady(task);
+        switchOut(task);
+    }
+}
+
+// returns false on timeout, or at once outside of a task
+static bool blockCurrent(const void *waitObject, int64_t timeoutUs)
+{
+    HostTask *task = taskCurrent;
+    if (!task || isrNesting || timeoutUs == 0)
+    {
+        return false;
+    }
+    task->state = HostTaskBlocked;
+    task->waitObject = waitObject;
+    task->timeWake = (timeoutUs == HOST_TIME_NEVER) ? HOST_TIME_NEVER : timeNow + timeoutUs;
+    task->isTimedOut = false;
+    switchOut(task);
+    return !task->isTimedOut;
+}
+
+static bool blockCurrentTicks(const void *waitObject, TickType_t ticks)
+{
+    return blockCurrent(waitObject, (ticks == portMAX_DELAY) ? HOST_TIME_NEVER : ticksToUs(ticks));
+}
+
+// the highest priority task waiting for object, first come first served among equals
+static void wakeWaiter(const void *object)
+{
+    HostTask *waiter = nullptr;
+    for (std::unique_ptr<HostTask> &task : tasks)
+    {
+        if (task->state == HostTaskBlocked && task->waitObject == object && object != nullptr &&
+            (!waiter || task->priority > waiter->priority))
+        {
+            waiter = task.get();
+        }
+    }
+    if (waiter)
+    {
+        makeReady(waiter);
+        preemptIfHigher();
+    }
+}
+
+static void taskEntry(void)
+{
+    HostTask *task = taskCurrent;
+    task->function(task->parameter);
+    task->state = HostTaskDeleted; // returned from its function, as vTaskDelete(nullptr)
+    switchOut(task);
+}
+
+static int64_t nextEventTime(void)
+{
+    if (isAsleep)
+    {
+        return HOST_TIME_NEVER;
+    }
+    int64_t next = HOST_TIME_NEVER;
+    for (std::unique_ptr<HostTask> &task : tasks)
+    {
+        if (task->state == HostTaskBlocked && task->timeWake < next)
+        {
+            next = task->timeWake;
+        }
+    }
+    for (HostTimer *timer : timers)
+    {
+        if (timer->isActive && timer->timeExpiry < next)
+        {
+            next = timer->timeExpiry;
+        }
+    }
+    return next;
+}
+
+// timeouts first, then the timer service: its callbacks run in expiry order, an auto-reload timer
+// late by several periods (e.g. after light sleep) fires once per period, as FreeRTOS does
+static void processTimeEvents(void)
+{
+    for (std::unique_ptr<HostTask> &task : tasks)
+    {
+        if (task->state == HostTaskBlocked && task->timeWake <= timeNow)
+        {
+            makeReady(task.get());
+            task->isTimedOut = true;
+        }
+    }
+    for (;;)
+    {
+        HostTimer *expired = nullptr;
+        for (HostTimer *timer : timers)
+        {
+            if (timer->isActive && timer->timeExpiry <= timeNow && (!expired || timer->timeExpiry < expired->timeExpiry))
+            {
+                expired = timer;
+            }
+        }
+        if (!expired)
+        {
+            return;
+        }
+        if (expired->autoReload && expired->period > 0)
+        {
+            expired->timeExpiry += ticksToUs(expired->period);
+        }
+        else
+        {
+            expired->isActive = false;
+        }
+        expired->callback(expired);
+    }
+}
+
+void hostSimRun(uint32_t us)
+{
+    int64_t timeEnd = timeNow + us;
+    for (;;)
+    {
+        HostTask *task = nextReadyTask();
+        if (task)
+        {
+            task->state = HostTaskRunning;
+            taskCurrent = task;
+            swapcontext(&contextScheduler, &task->context);
+            taskCurrent = nullptr;
+            continue;
+        }
+
+        int64_t timeNext = nextEventTime();
+        if (timeNext > timeEnd)
+        {
+            if (timeNow < timeEnd)
+            {
+                timeNow = timeEnd;
+            }
+            return;
+        }
+        if (timeNext > timeNow)
+        {
+            timeNow = timeNext;
+        }
+        processTimeEvents();
+    }
+}
+
+int64_t hostSimTime(void)
+{
+    return timeNow;
+}
+
+void hostIsrEnter(void)
+{
+    isrNesting++;
+}
+
+void hostIsrExit(void)
+{
+    isrNesting--;
+}
+
+void hostTaskDelayUs(uint32_t us)
+{
+    if (!taskCurrent || isrNesting)
+    {
+        hostBusyWaitUs(us);
+        return;
+    }
+    blockCurrent(nullptr, us);
+}
+
+void hostBusyWaitUs(uint32_t us)
+{
+    timeNow += us;
+}
+
+void hostSleepEnter(void)
+{
+    isAsleep = true;
+    blockCurrent(&isAsleep, HOST_TIME_NEVER);
+}
+
+void hostSleepWake(void)
+{
+    if (isAsleep)
+    {
+        isAsleep = false;
+        wakeWaiter(&isAsleep);
+    }
+}
+
+bool hostIsAsleep(void)
+{
+    return isAsleep;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// tasks
+/////////////////////////////////////////////////////////////////////////////
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(timeNow / 1000 / portTICK_PERIOD_MS);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    hostTaskDelayUs(ticksToUs(ticks));
+}
+
+// stack and taskBuffer of the target are not used, the task runs on a host stack
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameter,
+                                           UBaseType_t priority, StackType_t *, StaticTask_t *, BaseType_t)
+{
+    std::unique_ptr<HostTask> task(new HostTask());
+    task->name = name;
+    task->function = function;
+    task->parameter = parameter;
+    task->priority = priority;
+    task->stackDepth = stackDepth;
+    task->stack.reset(new uint8_t[HOST_TASK_STACK_SIZE]);
+    memset(task->stack.get(), HOST_STACK_FILL, HOST_TASK_STACK_SIZE);
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp = task->stack.get();
+    task->context.uc_stack.ss_size = HOST_TASK_STACK_SIZE;
+    task->context.uc_link = nullptr;
+    makecontext(&task->context, taskEntry, 0);
+    makeReady(task.get());
+
+    HostTask *handle = task.get();
+    tasks.push_back(std::move(task));
+    preemptIfHigher();
+    return handle;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return taskCurrent;
+}
+
+void vTaskPrioritySet(TaskHandle_t task, UBaseType_t priority)
+{
+    HostTask *target = toTask(task);
+    if (target)
+    {
+        target->priority = priority;
+        preemptIfHigher();
+    }
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+    HostTask *target = toTask(task);
+    return target ? target->priority : 0;
+}
+
+// the stack grows down from the end of the buffer, the fill pattern is left below the deepest use
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    HostTask *target = toTask(task);
+    if (!target)
+    {
+        return 0;
+    }
+    size_t unused = 0;
+    while (unused < HOST_TASK_STACK_SIZE && target->stack[unused] == HOST_STACK_FILL)
+    {
+        unused++;
+    }
+    size_t used = HOST_TASK_STACK_SIZE - unused;
+    return (used < target->stackDepth) ? (UBaseType_t)(target->stackDepth - used) : 0;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+    HostTask *task = taskCurrent;
+    if (!task)
+    {
+        return 0;
+    }
+    if (task->notifyCount == 0)
+    {
+        blockCurrentTicks(task, ticksToWait);
+    }
+    uint32_t count = task->notifyCount;
+    if (count)
+    {
+        task->notifyCount = clearCountOnExit ? 0 : count - 1;
+    }
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    HostTask *target = toTask(task);
+    if (target)
+    {
+        target->notifyCount++;
+        wakeWaiter(target);
+    }
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken)
+{
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken)
+    {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+}
+
+BaseType_t xPortInIsrContext(void)
+{
+    return isrNesting ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// queues: a task receiving from an empty queue blocks, a full queue rejects the item (no blocking send)
+/////////////////////////////////////////////////////////////////////////////
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t *, StaticQueue_t *)
+{
+    HostQueue *queue = new HostQueue(); // lives as long as the process, like a static queue
+    queue->length = length;
+    queue->itemSize = itemSize;
+    queue->peak = 0;
+    queue->rejected = 0;
+    queue->receiver = nullptr;
+    queues.push_back(queue);
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t)
+{
+    if (queue->items.size() >= queue->length)
+    {
+        queue->rejected++;
+        return pdFAIL;
+    }
+    const uint8_t *bytes = static_cast<const uint8_t *>(item);
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    if (queue->items.size() > queue->peak)
+    {
+        queue->peak = queue->items.size();
+    }
+    wakeWaiter(queue);
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *higherPriorityTaskWoken)
+{
+    if (higherPriorityTaskWoken)
+    {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticksToWait)
+{
+    if (taskCurrent && !isrNesting)
+    {
+        queue->receiver = taskCurrent;
+    }
+    if (queue->items.empty() && !blockCurrentTicks(queue, ticksToWait))
+    {
+        return pdFAIL;
+    }
+    if (queue->items.empty())
+    {
+        return pdFAIL;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return queue->items.size();
+}
+
+UBaseType_t hostQueueGetPeak(QueueHandle_t queue)
+{
+    return queue->peak;
+}
+
+uint32_t hostQueueGetRejected(QueueHandle_t queue)
+{
+    return queue->rejected;
+}
+
+QueueHandle_t hostTaskGetQueue(const char *taskName)
+{
+    for (HostQueue *queue : queues)
+    {
+        if (queue->receiver && strcmp(queue->receiver->name, taskName) == 0)
+        {
+            return queue;
+        }
+    }
+    return nullptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// timers: the command queue of the timer service is not modelled, a command takes effect at once
+/////////////////////////////////////////////////////////////////////////////
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t autoReload, void *timerId, TimerCallbackFunction_t callback)
+{
+    HostTimer *timer = new HostTimer{name, period, autoReload, timerId, callback, false, 0};
+    timers.push_back(timer);
+    return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t)
+{
+    timer->isActive = true;
+    timer->timeExpiry = timeNow + ticksToUs(timer->period);
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t)
+{
+    timer->isActive = false;
+    return pdPASS;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticksToWait)
+{
+    timer->period = period;
+    return xTimerStart(timer, ticksToWait); // as FreeRTOS: changing the period starts a dormant timer
+}
+
+BaseType_t xTimerStartFromISR(TimerHandle_t timer, BaseType_t *higherPriorityTaskWoken)
+{
+    if (higherPriorityTaskWoken)
+    {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return xTimerStart(timer, 0);
+}
+
+BaseType_t xTimerStopFromISR(TimerHandle_t timer, BaseType_t *higherPriorityTaskWoken)
+{
+    if (higherPriorityTaskWoken)
+    {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return xTimerStop(timer, 0);
+}
+
+BaseType_t xTimerChangePeriodFromISR(TimerHandle_t timer, TickType_t period, BaseType_t *higherPriorityTaskWoken)
+{
+    if (higherPriorityTaskWoken)
+    {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return xTimerChangePeriod(timer, period, 0);
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer)
+{
+    return timer->isActive ? pdTRUE : pdFALSE;
+}
+
+TickType_t xTimerGetPeriod(TimerHandle_t timer)
+{
+    return timer->period;
+}
+
+void *pvTimerGetTimerID(TimerHandle_t timer)
+{
+    return timer->timerId;
+}
@@ -0,0 +1,42 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// scheduler calls shared by the stand-ins of host/src, not part of any target API
+/////////////////////////////////////////////////////////////////////////////
+#include <stdint.h>
+#include <HostFreeRTOS.h>
+
+// an interrupt handler runs between the two calls: xPortInIsrContext() is true, nothing is preempted
+void hostIsrEnter(void);
+void hostIsrExit(void);
+
+// blocks the calling task for us of simulated time, e.g. a peripheral busy with a transfer;
+// outside of a task the time passes at once, as a busy wait
+void hostTaskDelayUs(uint32_t us);
+
+// the calling code keeps the CPU while us of simulated time pass
+void hostBusyWaitUs(uint32_t us);
+
+// light sleep: the calling task blocks, no task nor timer runs until hostSleepWake() while time passes
+void hostSleepEnter(void);
+void hostSleepWake(void);
+bool hostIsAsleep(void);
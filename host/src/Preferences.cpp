@@ -0,0 +1,108 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <map>
+#include <vector>
+#include <string.h>
+#include <Preferences.h>
+
+// namespace -> key -> value, shared by every Preferences instance like the NVS partition
+typedef std::map<std::string, std::vector<uint8_t>> HostNamespace;
+static std::map<std::string, HostNamespace> storage;
+
+bool Preferences::begin(const char *name, bool readOnly)
+{
+    if (_isStarted || name == nullptr)
+    {
+        return false;
+    }
+    // as NVS, a read-only namespace must exist already
+    if (readOnly && storage.find(name) == storage.end())
+    {
+        return false;
+    }
+    _name = name;
+    _isReadOnly = readOnly;
+    _isStarted = true;
+    storage[_name];
+    return true;
+}
+
+void Preferences::end(void)
+{
+    _isStarted = false;
+}
+
+bool Preferences::clear(void)
+{
+    if (!_isStarted || _isReadOnly)
+    {
+        return false;
+    }
+    storage[_name].clear();
+    return true;
+}
+
+size_t Preferences::putUInt(const char *key, uint32_t value)
+{
+    return putBytes(key, &value, sizeof(value));
+}
+
+uint32_t Preferences::getUInt(const char *key, uint32_t defaultValue)
+{
+    uint32_t value = defaultValue;
+    if (getBytesLength(key) == sizeof(value))
+    {
+        getBytes(key, &value, sizeof(value));
+    }
+    return value;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t length)
+{
+    if (!_isStarted || _isReadOnly || key == nullptr || (value == nullptr && length))
+    {
+        return 0;
+    }
+    const uint8_t *bytes = static_cast<const uint8_t *>(value);
+    storage[_name][key].assign(bytes, bytes + length);
+    return length;
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLength)
+{
+    size_t length = getBytesLength(key);
+    if (length == 0 || buf == nullptr || length > maxLength)
+    {
+        return 0;
+    }
+    memcpy(buf, storage[_name][key].data(), length);
+    return length;
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+    if (!_isStarted || key == nullptr)
+    {
+        return 0;
+    }
+    HostNamespace &ns = storage[_name];
+    HostNamespace::const_iterator it = ns.find(key);
+    return (it != ns.end()) ? it->second.size() : 0;
+}
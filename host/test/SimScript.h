@@ -0,0 +1,69 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <Arduino.h>
+#include <HostSim.h>
+#include "pins.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// scripted button input for the tests running the sketch on the simulated target
+// buttons are active low with a pull-up; a contact bounces `bounces` times, SCRIPT_BOUNCE_US apart,
+// before it settles at its new level
+////////////////////////////////////////////////////////////////////////////////////////////
+#define SCRIPT_BOUNCE_US 100
+#define SCRIPT_BOOT_US (100 * 1000)
+
+static constexpr uint8_t scriptPlayerPins[] = PINS_SW_PLAYER;
+
+// the sketch booted: the tasks are waiting for events
+static inline void scriptBoot(void)
+{
+    hostArduinoStart(setup, loop);
+    hostSimRun(SCRIPT_BOOT_US);
+}
+
+// the first edge is at the current time, returns once the contact settled
+static inline void scriptSetButton(uint8_t pin, bool isPressed, uint8_t bounces = 0)
+{
+    uint8_t level = isPressed ? LOW : HIGH;
+    for (uint8_t i = 0; i < bounces; i++)
+    {
+        hostSetPinLevel(pin, level);
+        hostSimRun(SCRIPT_BOUNCE_US);
+        hostSetPinLevel(pin, !level);
+        hostSimRun(SCRIPT_BOUNCE_US);
+    }
+    hostSetPinLevel(pin, level);
+}
+
+// press, hold for holdUs, release: the click is reported on the release edge
+static inline void scriptClick(uint8_t pin, uint32_t holdUs, uint8_t bounces = 0)
+{
+    scriptSetButton(pin, true, bounces);
+    hostSimRun(holdUs);
+    scriptSetButton(pin, false, bounces);
+}
+
+// a click on button "Game" is reported once the double click time has passed: the game starts
+static inline void scriptStartGame(void)
+{
+    scriptClick(PIN_SW_GAME, 50 * 1000);
+    hostSimRun(600 * 1000);
+}
@@ -0,0 +1,92 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <DebugLog.h>
+#include <FastLED.h>
+#include "AppConfig.h"
+#include "./SimScript.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// host run of the boot benchmark of ThreadGame (APP_BENCHMARK, see thread/ThreadGameBenchmark.cpp): the sketch
+// boots on the simulated target and ThreadGame::runBenchmark drives the real click path, handlerEventUser ->
+// GameEngine::advance -> render (updateState, updateUi) down to RoundLed and the FastLED stand-in, for 2 to 8
+// players at 1, 4 and 16 clicks per frame. cycles are the host clock at the nominal CPU frequency, allocations
+// are counted by the operator new of the stand-ins.
+// its JSON lines are printed as they are, the run fails if a case is missing or allocates per click
+////////////////////////////////////////////////////////////////////////////////////////////
+#define BENCH_CASES ((GAME_NUM_PLAYERS - 1) * 3) // players 2 to GAME_NUM_PLAYERS, 3 clicks per frame
+
+static std::string serialLine;
+static uint32_t benchCases = 0;
+static uint32_t benchAllocating = 0;
+
+// a JSON line of the benchmark: {"benchmark":"engine",...,"allocPerEvent":0.000}
+static void onSerialLine(const std::string &line)
+{
+    fputs(line.c_str(), stdout);
+    static const char prefix[] = "{\"benchmark\":\"engine\",";
+    if (line.compare(0, sizeof(prefix) - 1, prefix) != 0)
+    {
+        return;
+    }
+    benchCases++;
+    const char *alloc = strstr(line.c_str(), "\"allocPerEvent\":");
+    if (alloc == nullptr || atof(alloc + strlen("\"allocPerEvent\":")) != 0)
+    {
+        benchAllocating++;
+    }
+}
+
+int main(void)
+{
+    hostLogSetMaxLevel(DebugLogLevel::LVL_WARN);
+    Serial.hostSetSink([](const uint8_t *data, size_t size)
+                       {
+                           for (size_t i = 0; i < size; i++)
+                           {
+                               serialLine += (char)data[i];
+                               if (data[i] == '\n')
+                               {
+                                   onSerialLine(serialLine);
+                                   serialLine.clear();
+                               }
+                           } });
+    scriptBoot();
+    Serial.hostSetSink(nullptr);
+
+    if (benchCases != BENCH_CASES)
+    {
+        printf("FAIL %u of %u cases printed\n", benchCases, BENCH_CASES);
+        return 1;
+    }
+    if (benchAllocating)
+    {
+        printf("FAIL %u cases allocate on the heap per click\n", benchAllocating);
+        return 1;
+    }
+    if (FastLED.hostGetFramesShown() == 0)
+    {
+        printf("FAIL no frame shown\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include "peripheral/LedAnimation.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// host micro-benchmark of LedAnimation::compose on tracks of 16 to 1024 leds: every player moves a led
+// every 4 frames, markers gliding (run) or the win effect. one JSON object per line is printed for each (mode, leds) case.
+// the run fails if the frame composed right after a move does not light the new position, or if
+// the markers of all players at the start are not mixed on led 0
+////////////////////////////////////////////////////////////////////////////////////////////
+#define BENCH_FRAMES 4096
+#define BENCH_TRACK_MAX 1024
+#define BENCH_FRAME_MS 16 // about 60 frames/s
+
+static const uint16_t benchTrackLeds[] = {16, 60, 144, 300, BENCH_TRACK_MAX};
+static uint8_t benchTrack[BENCH_TRACK_MAX];
+static double benchNs[BENCH_FRAMES];
+
+// every marker is on led 0 after reset(): one mix slot holds all players at full level
+static int checkStartMix(void)
+{
+    LedAnimation animation(BENCH_TRACK_MAX);
+    animation.compose(benchTrack, 0);
+    if (!isMixIndex(benchTrack[0]) || animation.getMixCount() != 1 || animation.getMixSlots()[0].position != 0)
+    {
+        printf("FAIL start: led 0 is not mixed, index %u, mix slots %u\n", benchTrack[0], animation.getMixCount());
+        return 1;
+    }
+    for (uint8_t p = 0; p < GAME_NUM_PLAYERS; p++)
+    {
+        if (animation.getMixSlots()[0].level[p] != FadeLevelMax)
+        {
+            printf("FAIL start: Player%u is not mixed on led 0\n", p + 1);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(void)
+{
+    if (checkStartMix())
+    {
+        return 1;
+    }
+
+    static const AnimationMode modes[] = {AnimationRun, AnimationWin};
+    static const char *modeNames[] = {"run", "win"};
+
+    for (uint16_t leds : benchTrackLeds)
+    {
+        for (uint8_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+        {
+            LedAnimation animation(leds);
+            animation.play(modes[m], 0, 0);
+            uint16_t position = 0;
+            for (uint32_t i = 0; i < BENCH_FRAMES; i++)
+            {
+                bool isMoved = (i % 4) == 0;
+                if (isMoved)
+                {
+                    position = (position + 1) % leds;
+                    for (uint8_t p = 0; p < GAME_NUM_PLAYERS; p++)
+                    {
+                        animation.setTarget(p, (position + p * leds / GAME_NUM_PLAYERS) % leds);
+                    }
+                }
+                std::chrono::steady_clock::time_point timeStart = std::chrono::steady_clock::now();
+                animation.compose(benchTrack, i * BENCH_FRAME_MS);
+                std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - timeStart;
+                benchNs[i] = elapsed.count();
+
+                // click latency: a moved player is on its new led in this very frame
+                if (isMoved && modes[m] == AnimationRun && (benchTrack[position] & FadeLevelMax) == 0 && !isMixIndex(benchTrack[position]))
+                {
+                    printf("FAIL %u leds, frame %u: led %u of Player1 is off\n", leds, i, position);
+                    return 1;
+                }
+            }
+
+            std::sort(benchNs, benchNs + BENCH_FRAMES);
+            printf("{\"benchmark\":\"compose\",\"mode\":\"%s\",\"leds\":%u,\"frames\":%u,"
+                   "\"nsP50\":%.0f,\"nsP99\":%.0f,\"nsMax\":%.0f}\n",
+                   modeNames[m], leds, BENCH_FRAMES,
+                   benchNs[BENCH_FRAMES / 2], benchNs[BENCH_FRAMES * 99 / 100], benchNs[BENCH_FRAMES - 1]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,158 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <DebugLog.h>
+#include <FastLED.h>
+#include <HostSim.h>
+#include "AppContext.h"
+#include "AppMessage.h"
+#include "thread/QueueMain.h"
+#include "thread/ThreadGame.h"
+#include "peripheral/PowerManager.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// host micro-benchmark of message dispatch: the real QueueMain::onMessage and ThreadGame::onMessage,
+// called through MessageQueue::onMessage of the ArduProf stand-in as the message loops do, handlers included.
+// the app is created as the sketch does, then the benchmark runs in the loop task instead of its message loop.
+// the streams mix the events each one handles with EventNull and events nobody handles, as a busy queue would;
+// player clicks go round-robin so the race runs to the end of the stream.
+// one JSON object per line is printed for each target, the run fails if a message allocates on the heap
+////////////////////////////////////////////////////////////////////////////////////////////
+#define BENCH_MESSAGES (1u << 16)
+#define BENCH_UNKNOWN_EVENTS 16 // distinct unhandled event ids in the stream
+
+static AppContext appContext = {0};
+static Message benchMessages[BENCH_MESSAGES];
+static double benchNs[BENCH_MESSAGES];
+static int benchResult = -1; // -1 until the loop task has run the benchmark
+
+static const EventParams queueMainEvents[] = {
+    GpioEdgeReady{}.encode(),
+    TimerTick{TimerIdDebounce}.encode(),
+    EventParams{EventNull, 0, 0, 0},
+};
+static const EventParams threadGameEvents[] = {
+    UserInput{UserClick, ButtonIdPlayer1, 0}.encode(), // the player is picked round-robin
+    UserInput{UserClick, ButtonIdPlayer1, 0}.encode(),
+    UserInput{UserClick, ButtonIdPlayer1, 0}.encode(),
+    TimerTick{TimerIdFrame}.encode(),
+    LedTxDone{0}.encode(),
+    EventParams{EventNull, 0, 0, 0},
+};
+
+// a fixed, unpredictable stream of events, with a few unknown to the target
+static void makeMessages(const EventParams *events, uint8_t numEvents)
+{
+    uint32_t seed = 1;
+    uint32_t clicks = 0;
+    for (uint32_t i = 0; i < BENCH_MESSAGES; i++)
+    {
+        seed = seed * 1664525 + 1013904223; // LCG
+        uint32_t pick = seed >> 24;
+        EventParams params = (pick < 240) ? events[pick % numEvents] : EventParams{(int16_t)(1000 + pick % BENCH_UNKNOWN_EVENTS), 0, 0, 0};
+        if (params.event == EventUser)
+        {
+            params.uParam = (uint16_t)(ButtonIdPlayer1 + clicks++ % GAME_NUM_PLAYERS);
+        }
+        benchMessages[i] = Message{params.event, params.iParam, params.uParam, params.lParam};
+    }
+}
+
+static int runDispatch(const char *name, ardufreertos::MessageQueue &target)
+{
+    uint32_t allocations = hostHeapGetAllocations();
+    for (uint32_t i = 0; i < BENCH_MESSAGES; i++)
+    {
+        std::chrono::steady_clock::time_point timeStart = std::chrono::steady_clock::now();
+        target.onMessage(benchMessages[i]);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - timeStart;
+        benchNs[i] = elapsed.count();
+    }
+    allocations = hostHeapGetAllocations() - allocations;
+
+    double nsTotal = 0;
+    for (uint32_t i = 0; i < BENCH_MESSAGES; i++)
+    {
+        nsTotal += benchNs[i];
+    }
+    std::sort(benchNs, benchNs + BENCH_MESSAGES);
+    printf("{\"benchmark\":\"dispatch\",\"target\":\"%s\",\"messages\":%u,\"nsMean\":%.1f,\"nsP50\":%.0f,"
+           "\"nsP99\":%.0f,\"nsMax\":%.0f,\"allocations\":%u}\n",
+           name, BENCH_MESSAGES, nsTotal / BENCH_MESSAGES, benchNs[BENCH_MESSAGES / 2],
+           benchNs[BENCH_MESSAGES * 99 / 100], benchNs[BENCH_MESSAGES - 1], allocations);
+    if (allocations)
+    {
+        printf("FAIL %s: %u allocations\n", name, allocations);
+        return 1;
+    }
+    return 0;
+}
+
+// as createTasks() of the sketch
+static void benchSetup(void)
+{
+    static freertos::QueueMain queueMain;
+    static freertos::ThreadGame threadGame;
+    static PowerManager powerManager;
+
+    appContext.powerManager = &powerManager;
+    appContext.queueMain = &queueMain;
+    appContext.threadGame = &threadGame;
+
+    queueMain.start(&appContext);
+    threadGame.start(&appContext);
+}
+
+// waits for ThreadGame to set up, runs once, then waits for ever
+static void benchLoop(void)
+{
+    vTaskDelay(pdMS_TO_TICKS(10));
+    makeMessages(queueMainEvents, sizeof(queueMainEvents) / sizeof(queueMainEvents[0]));
+    benchResult = runDispatch("QueueMain", *appContext.queueMain);
+
+    // a click on button "Game" starts the race
+    appContext.threadGame->onMessage(Message{EVENT_ARGS(UserInput{UserClick, ButtonIdGame, 0})});
+    makeMessages(threadGameEvents, sizeof(threadGameEvents) / sizeof(threadGameEvents[0]));
+    benchResult |= runDispatch("ThreadGame", *appContext.threadGame);
+
+    vTaskDelay(portMAX_DELAY);
+}
+
+int main(void)
+{
+    hostLogSetMaxLevel(DebugLogLevel::LVL_WARN);
+    hostArduinoStart(benchSetup, benchLoop);
+    hostSimRun(100 * 1000);
+
+    if (benchResult < 0)
+    {
+        printf("FAIL the benchmark did not run\n");
+        return 1;
+    }
+    // the frame rendered by the last click is transmitted once the loop task waits
+    if (FastLED.hostGetFramesShown() < 2)
+    {
+        printf("FAIL ThreadGame rendered no frame, frames shown=%u\n", FastLED.hostGetFramesShown());
+        return 1;
+    }
+    return benchResult;
+}
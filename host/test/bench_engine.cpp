@@ -0,0 +1,88 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include "game/GameEngine.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// host micro-benchmark of GameEngine::advance for every number of players of a race.
+// the players click round-robin, as the boot benchmark of ThreadGame does: nobody laps, so
+// the race must still run at the end. clicks are timed in batches, the clock costs more than a click.
+// one JSON object per line is printed for each number of players
+////////////////////////////////////////////////////////////////////////////////////////////
+#define BENCH_TRACK_LENGTH 16
+#define BENCH_BATCH 64 // clicks per timed batch
+#define BENCH_BATCHES (1u << 14)
+
+static double benchNs[BENCH_BATCHES]; // per click, of each batch
+
+static int fail(const char *what, uint8_t players)
+{
+    printf("FAIL %s, players=%u\n", what, players);
+    return 1;
+}
+
+int main(void)
+{
+    GameEngine engine(BENCH_TRACK_LENGTH);
+    for (uint8_t players = 2; players <= GameEngine::getMaxPlayers(); players++)
+    {
+        engine.reset(players);
+        if (engine.getNumPlayers() != players)
+        {
+            return fail("engine: wrong number of players", players);
+        }
+        if (players < GameEngine::getMaxPlayers() && engine.advance((GamePlayer)players))
+        {
+            return fail("engine: a player out of the race moved", players);
+        }
+
+        uint32_t click = 0;
+        uint32_t moves = 0;
+        for (uint32_t b = 0; b < BENCH_BATCHES; b++)
+        {
+            std::chrono::steady_clock::time_point timeStart = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < BENCH_BATCH; i++, click++)
+            {
+                moves += engine.advance((GamePlayer)(click % players));
+            }
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - timeStart;
+            benchNs[b] = elapsed.count() / BENCH_BATCH;
+        }
+        if (engine.getWinner() != PlayerNull)
+        {
+            return fail("engine: round-robin clicks must not end the race", players);
+        }
+
+        double nsTotal = 0;
+        for (uint32_t b = 0; b < BENCH_BATCHES; b++)
+        {
+            nsTotal += benchNs[b];
+        }
+        std::sort(benchNs, benchNs + BENCH_BATCHES);
+        printf("{\"benchmark\":\"engine\",\"players\":%u,\"events\":%u,\"moves\":%u,\"eventsPerSec\":%.0f,"
+               "\"nsP50\":%.2f,\"nsP90\":%.2f,\"nsP99\":%.2f,\"nsMax\":%.2f}\n",
+               players, click, moves, nsTotal ? (double)click * 1e9 / (nsTotal * BENCH_BATCH) : 0.0,
+               benchNs[BENCH_BATCHES / 2], benchNs[BENCH_BATCHES * 90 / 100],
+               benchNs[BENCH_BATCHES * 99 / 100], benchNs[BENCH_BATCHES - 1]);
+    }
+    return 0;
+}
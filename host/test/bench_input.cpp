@@ -0,0 +1,143 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <time.h>
+#include <stdio.h>
+#include <DebugLog.h>
+#include <HostSim.h>
+#include "AppConfig.h"
+#include "peripheral/button/ButtonPoller.h"
+#include "peripheral/button/DebounceButton.h"
+#include "util/LatencyStat.h"
+#include "./SimScript.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// button input of the sketch on the simulated target, built twice: bench_input takes the edges from the
+// GPIO interrupts, bench_input_polling samples the buttons from ButtonPoller (APP_BUTTON_POLLING).
+// the same script runs on both: a stopped game left idle, then a game with bouncing clicks.
+// one JSON object per line is printed for each phase: the calls of the input path (ISR or poll), the
+// accepted edges, the clicks received by ThreadGame and the host CPU time of the whole simulation.
+// Serial, with the binary trace records of the sketch, is dropped.
+// polling must stop while the game is stopped and idle, and the click which starts the game must wake it up
+////////////////////////////////////////////////////////////////////////////////////////////
+#define BENCH_IDLE_US (10 * 1000 * 1000)
+#define BENCH_CLICKS 20
+#define BENCH_HOLD_US (30 * 1000)
+#define BENCH_GAP_US (40 * 1000)
+#define BENCH_BOUNCES 3
+
+// fast samples after the last edge, slow samples while idle, then the timer stops
+#define BENCH_POLL_MAX_IDLE_CALLS (ButtonPollStableSamples + 2 * ButtonPollIdleSamples)
+
+#ifdef APP_BUTTON_POLLING
+#define BENCH_INPUT "polling"
+#else
+#define BENCH_INPUT "isr"
+#endif
+
+typedef struct _BenchSample
+{
+    InputStat input;
+    uint32_t clicks;
+    uint64_t cpuNs;
+} BenchSample;
+
+static int fail(const char *what, uint32_t value)
+{
+    printf("FAIL %s: %u\n", what, (unsigned)value);
+    return 1;
+}
+
+static const InputStat &inputStat(void)
+{
+#ifdef APP_BUTTON_POLLING
+    return ButtonPoller::getInstance()->getStat();
+#else
+    return DebounceButton::getIsrStat();
+#endif
+}
+
+static BenchSample sample(void)
+{
+    timespec cpu;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+    return BenchSample{inputStat(), clickLatency.isrToThreadGame.count(), (uint64_t)cpu.tv_sec * 1000000000ull + cpu.tv_nsec};
+}
+
+static void printPhase(const char *phase, uint32_t simUs, const BenchSample &begin, const BenchSample &end)
+{
+    printf("{\"input\":\"%s\",\"phase\":\"%s\",\"simMs\":%u,\"calls\":%u,\"edges\":%u,\"clicks\":%u,\"cpuUs\":%u}\n",
+           BENCH_INPUT, phase, (unsigned)(simUs / 1000), (unsigned)(end.input.calls - begin.input.calls),
+           (unsigned)(end.input.edges - begin.input.edges), (unsigned)(end.clicks - begin.clicks),
+           (unsigned)((end.cpuNs - begin.cpuNs) / 1000));
+}
+
+// nobody touches a button while the game is stopped
+static int benchIdle(void)
+{
+    BenchSample begin = sample();
+    hostSimRun(BENCH_IDLE_US);
+    BenchSample end = sample();
+    printPhase("idle", BENCH_IDLE_US, begin, end);
+
+#ifdef APP_BUTTON_POLLING
+    if (end.input.calls - begin.input.calls > BENCH_POLL_MAX_IDLE_CALLS)
+    {
+        return fail("polls while the game is stopped", end.input.calls - begin.input.calls);
+    }
+    if (ButtonPoller::getInstance()->getRate() != PollRateOff)
+    {
+        return fail("poll rate while the game is stopped", ButtonPoller::getInstance()->getRate());
+    }
+#endif
+    if (end.input.edges != begin.input.edges)
+    {
+        return fail("edges while the game is stopped", end.input.edges - begin.input.edges);
+    }
+    return 0;
+}
+
+// the click on button "Game" wakes the input up, then the players click in turn
+static int benchPlay(void)
+{
+    BenchSample begin = sample();
+    int64_t start = hostSimTime();
+    scriptStartGame();
+    for (uint8_t i = 0; i < BENCH_CLICKS; i++)
+    {
+        scriptClick(scriptPlayerPins[i % 2], BENCH_HOLD_US, BENCH_BOUNCES);
+        hostSimRun(BENCH_GAP_US);
+    }
+    BenchSample end = sample();
+    printPhase("play", (uint32_t)(hostSimTime() - start), begin, end);
+
+    if (end.clicks - begin.clicks != BENCH_CLICKS)
+    {
+        return fail("clicks received by ThreadGame", end.clicks - begin.clicks);
+    }
+    return 0;
+}
+
+int main(void)
+{
+    hostLogSetMaxLevel(DebugLogLevel::LVL_WARN);
+    Serial.hostSetSink([](const uint8_t *, size_t) {});
+    scriptBoot();
+    return benchIdle() || benchPlay();
+}
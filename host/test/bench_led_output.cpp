@@ -0,0 +1,112 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include "peripheral/LedOutput.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// host micro-benchmark of the output stage of RoundLed (peripheral/LedOutput.h) on tracks of 16 to 1024 leds:
+// a frame of palette indices is expanded through the palette and the gamma/brightness table, then limited to
+// the current budget. frames are random, so about half of the full current: every frame of a long track is
+// scaled down. one JSON object per line is printed for each track length, with the time to build the table.
+// the run fails if a frame above the budget is not scaled down to it, or to black if the idle current of
+// the leds alone exceeds it (1024 leds draw 1024 mA when off)
+////////////////////////////////////////////////////////////////////////////////////////////
+#define BENCH_FRAMES 2048
+#define BENCH_TRACK_MAX 1024
+#define BENCH_BUDGET_MA 400 // LED_POWER_BUDGET_MA of AppConfig.h
+
+static const uint16_t benchTrackLeds[] = {16, 60, 144, 300, BENCH_TRACK_MAX};
+static uint8_t benchIndex[BENCH_TRACK_MAX];
+static CRGB benchOut[BENCH_TRACK_MAX];
+static double benchNs[BENCH_FRAMES];
+
+static ledpattern::Palette benchPalette;
+static uint8_t benchLut[256];
+
+template <typename F>
+static double runNs(F &&run)
+{
+    std::chrono::steady_clock::time_point timeStart = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - timeStart;
+    return elapsed.count();
+}
+
+int main(void)
+{
+    uint32_t seed = 1;
+    auto random8 = [&seed](void)
+    {
+        seed = seed * 1664525 + 1013904223; // LCG: a fixed, unpredictable stream
+        return (uint8_t)(seed >> 24);
+    };
+    for (ledpattern::Rgb &color : benchPalette.color)
+    {
+        color = ledpattern::Rgb{random8(), random8(), random8()};
+    }
+
+    double lutNs = runNs([]
+                         { ledoutput::buildLut(benchLut, 255); });
+
+    for (uint16_t leds : benchTrackLeds)
+    {
+        uint32_t framesLimited = 0;
+        for (uint32_t f = 0; f < BENCH_FRAMES; f++)
+        {
+            for (uint16_t i = 0; i < leds; i++)
+            {
+                benchIndex[i] = random8();
+            }
+
+            uint32_t levelSum = 0;
+            bool isLimited = false;
+            benchNs[f] = runNs([&]
+                               {
+                                   levelSum = ledoutput::expand(benchIndex, benchPalette, benchLut, benchOut, leds);
+                                   isLimited = ledoutput::limitPower(benchOut, leds, levelSum, BENCH_BUDGET_MA); });
+            framesLimited += isLimited;
+
+            if (ledoutput::currentMa(levelSum, leds) > BENCH_BUDGET_MA)
+            {
+                uint32_t limitedSum = 0;
+                for (uint16_t i = 0; i < leds; i++)
+                {
+                    limitedSum += benchOut[i].r + benchOut[i].g + benchOut[i].b;
+                }
+                uint32_t floorMa = std::max<uint32_t>(BENCH_BUDGET_MA, ledoutput::currentMa(0, leds));
+                if (!isLimited || ledoutput::currentMa(limitedSum, leds) > floorMa)
+                {
+                    printf("FAIL %u leds, frame %u: %u mA over the budget of %u mA\n",
+                           leds, f, ledoutput::currentMa(limitedSum, leds), BENCH_BUDGET_MA);
+                    return 1;
+                }
+            }
+        }
+
+        std::sort(benchNs, benchNs + BENCH_FRAMES);
+        printf("{\"benchmark\":\"ledOutput\",\"leds\":%u,\"frames\":%u,\"framesLimited\":%u,\"nsP50\":%.0f,\"nsP99\":%.0f,"
+               "\"nsMax\":%.0f,\"nsPerLed\":%.2f,\"lutNs\":%.0f}\n",
+               leds, BENCH_FRAMES, framesLimited, benchNs[BENCH_FRAMES / 2], benchNs[BENCH_FRAMES * 99 / 100],
+               benchNs[BENCH_FRAMES - 1], benchNs[BENCH_FRAMES / 2] / leds, lutNs);
+    }
+    return 0;
+}
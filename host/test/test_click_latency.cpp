@@ -0,0 +1,172 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <stdio.h>
+#include <DebugLog.h>
+#include <FastLED.h>
+#include <HostSim.h>
+#include "AppConfig.h"
+#include "AppEvent.h"
+#include "peripheral/button/DebounceButton.h"
+#include "peripheral/RoundLed.h"
+#include "util/LatencyStat.h"
+#include "./SimScript.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// the sketch on the simulated target: scripted bouncing clicks go through the GPIO interrupts, QueueMain,
+// ThreadGame and the LED transmit task, the click latencies and the queue depths are checked.
+// code costs no simulated time, a frame takes its WS2812 transmission time: a click is shown one frame
+// after its release edge, or two if a frame of the animation is already on the wire
+////////////////////////////////////////////////////////////////////////////////////////////
+#define TEST_CLICKS 10
+#define TEST_HOLD_US (30 * 1000)
+#define TEST_GAP_US (40 * 1000)
+#define TEST_BOUNCES 3
+#define FRAME_TX_US (RoundLed::getTotalLeds() * HOST_WS2812_US_PER_LED + HOST_WS2812_RESET_US)
+
+static int fail(const char *what, uint32_t value)
+{
+    printf("FAIL %s: %u\n", what, (unsigned)value);
+    return 1;
+}
+
+static void printHistogram(const char *name, const LatencyHistogram &histogram)
+{
+    printf("{\"latency\":\"%s\",\"count\":%u,\"minUs\":%u,\"meanUs\":%u,\"maxUs\":%u}\n", name,
+           (unsigned)histogram.count(), (unsigned)histogram.min(), (unsigned)histogram.mean(), (unsigned)histogram.max());
+}
+
+// two players click in turn, one click at a time
+static int testClicks(void)
+{
+    for (uint8_t i = 0; i < TEST_CLICKS; i++)
+    {
+        scriptClick(scriptPlayerPins[i % 2], TEST_HOLD_US, TEST_BOUNCES);
+        hostSimRun(TEST_GAP_US);
+    }
+
+    printHistogram("isrToQueueMain", clickLatency.isrToQueueMain);
+    printHistogram("isrToThreadGame", clickLatency.isrToThreadGame);
+    printHistogram("isrToShow", clickLatency.isrToShow);
+    if (clickLatency.isrToThreadGame.count() != TEST_CLICKS)
+    {
+        return fail("clicks received by ThreadGame", clickLatency.isrToThreadGame.count());
+    }
+    if (clickLatency.isrToThreadGame.max() != 0)
+    {
+        return fail("ISR to ThreadGame should take no simulated time, max us", clickLatency.isrToThreadGame.max());
+    }
+    if (clickLatency.isrToShow.count() != TEST_CLICKS)
+    {
+        return fail("clicks shown", clickLatency.isrToShow.count());
+    }
+    if (clickLatency.isrToShow.min() != FRAME_TX_US)
+    {
+        return fail("ISR to show should be one frame at best, min us", clickLatency.isrToShow.min());
+    }
+    if (clickLatency.isrToShow.max() > 2 * FRAME_TX_US)
+    {
+        return fail("ISR to show should be two frames at worst, max us", clickLatency.isrToShow.max());
+    }
+    return 0;
+}
+
+// every player releases at the same time: QueueMain gets one EventGpioISR for all edges and posts one
+// click per player before ThreadGame, at a lower priority, runs
+static int testBurst(void)
+{
+    for (uint8_t pin : scriptPlayerPins)
+    {
+        hostSetPinLevel(pin, LOW);
+    }
+    hostSimRun(TEST_HOLD_US);
+    for (uint8_t pin : scriptPlayerPins)
+    {
+        hostSetPinLevel(pin, HIGH);
+    }
+    hostSimRun(TEST_GAP_US);
+
+    QueueHandle_t queueMain = hostTaskGetQueue("loopTask");
+    QueueHandle_t queueGame = hostTaskGetQueue("ThreadGame");
+    printf("{\"queue\":\"QueueMain\",\"peak\":%u,\"rejected\":%u}\n", (unsigned)hostQueueGetPeak(queueMain), (unsigned)hostQueueGetRejected(queueMain));
+    printf("{\"queue\":\"ThreadGame\",\"peak\":%u,\"rejected\":%u}\n", (unsigned)hostQueueGetPeak(queueGame), (unsigned)hostQueueGetRejected(queueGame));
+    if (hostQueueGetPeak(queueMain) != 1)
+    {
+        return fail("QueueMain peak", hostQueueGetPeak(queueMain));
+    }
+    if (hostQueueGetPeak(queueGame) < GAME_NUM_PLAYERS || hostQueueGetPeak(queueGame) > PROFILE_THREAD_GAME_QUEUE_PEAK)
+    {
+        return fail("ThreadGame peak", hostQueueGetPeak(queueGame));
+    }
+    if (hostQueueGetRejected(queueMain) || hostQueueGetRejected(queueGame))
+    {
+        return fail("messages rejected", hostQueueGetRejected(queueMain) + hostQueueGetRejected(queueGame));
+    }
+    if (clickLatency.isrToThreadGame.count() != TEST_CLICKS + GAME_NUM_PLAYERS)
+    {
+        return fail("clicks received by ThreadGame", clickLatency.isrToThreadGame.count());
+    }
+    return 0;
+}
+
+// the queue of QueueMain is full when a click is released: its EventGpioISR is lost, the edges wait in the
+// ring and the next edge sends it again, so both the lost click and the next one come through
+static int testQueueFull(void)
+{
+    uint32_t clicks = clickLatency.isrToThreadGame.count();
+    uint32_t notifyLost = DebounceButton::getIsrStat().notifyLost;
+    scriptSetButton(scriptPlayerPins[0], true);
+    hostSimRun(TEST_HOLD_US);
+
+    QueueHandle_t queueMain = hostTaskGetQueue("loopTask");
+    Message msg = {EventNull, 0, 0, 0};
+    while (xQueueSend(queueMain, &msg, 0) == pdTRUE)
+    {
+    }
+    scriptSetButton(scriptPlayerPins[0], false);
+    hostSimRun(TEST_GAP_US);
+    if (DebounceButton::getIsrStat().notifyLost != notifyLost + 1)
+    {
+        return fail("EventGpioISR lost", DebounceButton::getIsrStat().notifyLost - notifyLost);
+    }
+    if (clickLatency.isrToThreadGame.count() != clicks)
+    {
+        return fail("clicks received by ThreadGame while the EventGpioISR is lost", clickLatency.isrToThreadGame.count() - clicks);
+    }
+
+    scriptClick(scriptPlayerPins[1], TEST_HOLD_US);
+    hostSimRun(TEST_GAP_US);
+    if (clickLatency.isrToThreadGame.count() != clicks + 2)
+    {
+        return fail("clicks received by ThreadGame after the next edge", clickLatency.isrToThreadGame.count() - clicks);
+    }
+    return 0;
+}
+
+int main(void)
+{
+    hostLogSetMaxLevel(DebugLogLevel::LVL_WARN);
+    scriptBoot();
+    if (FastLED.hostGetFramesShown() != 1)
+    {
+        return fail("frames shown at boot", FastLED.hostGetFramesShown());
+    }
+    scriptStartGame();
+    return testClicks() || testBurst() || testQueueFull();
+}
@@ -0,0 +1,194 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <stdio.h>
+#include <vector>
+#include <DebugLog.h>
+#include <FastLED.h>
+#include <HostSim.h>
+#include "AppMessage.h"
+#include "peripheral/RoundLed.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// RoundLed on the simulated target, the FastLED sink records every frame latched by the leds.
+// the loop task composes frames as ThreadGame does and waits for their EventSystem/SysLedTxDone:
+// - a tagged frame returns its tag when it is latched, one frame time after the commit
+// - a frame equal to the one on the leds is skipped, its tag is dropped and not carried to the next frame
+// - frames committed during a transmission are coalesced into the last one, which keeps the tag of the
+//   earliest click and is latched one frame time after the frame on the wire
+// each frame lights a different number of leds, so the sink tells which frame it got
+////////////////////////////////////////////////////////////////////////////////////////////
+#define FRAME_TX_US (RoundLed::getTotalLeds() * HOST_WS2812_US_PER_LED + HOST_WS2812_RESET_US)
+#define TEST_QUEUE_LENGTH 4
+#define TEST_TAG_1 1000
+#define TEST_TAG_2 2000
+#define TEST_TAG_3 3000
+#define TEST_TAG_4 4000
+
+typedef struct _ShownFrame
+{
+    uint16_t litLeds;
+    int64_t timeShown;
+} ShownFrame;
+
+static std::vector<ShownFrame> shownFrames;
+static uint8_t queueStorage[TEST_QUEUE_LENGTH * sizeof(Message)];
+static StaticQueue_t queueBuffer;
+static QueueHandle_t queue;
+static uint8_t track[RoundLed::getTotalLeds()];
+static int testResult = -1; // -1 until the loop task has run the test
+
+static int fail(const char *what, uint32_t value)
+{
+    printf("FAIL %s: %u\n", what, (unsigned)value);
+    return 1;
+}
+
+// player 1 at full level on the first litLeds leds of the track
+static void showFrame(RoundLed &rLed, uint16_t litLeds)
+{
+    for (uint16_t i = 0; i < RoundLed::getTotalLeds(); i++)
+    {
+        track[i] = fadeIndex(0, (i < litLeds) ? FadeLevelMax : 0);
+    }
+    rLed.uiShowFade(track);
+}
+
+// the next SysLedTxDone, latched: the frame it reports is the last one of the sink, latched at the time it is received
+static int waitTxDone(RoundLed &rLed, uint16_t litLeds, uint32_t tag, uint32_t timeExpected)
+{
+    Message msg;
+    if (xQueueReceive(queue, &msg, portMAX_DELAY) != pdPASS || msg.event != EventSystem || msg.iParam != SysLedTxDone)
+    {
+        return fail("SysLedTxDone expected, event", msg.event);
+    }
+    uint32_t now = micros();
+    rLed.onTxDone();
+    if (LedTxDone::decode(msg).timestamp != tag)
+    {
+        return fail("tag of the frame", LedTxDone::decode(msg).timestamp);
+    }
+    if (now != timeExpected)
+    {
+        return fail("SysLedTxDone at us", now - timeExpected);
+    }
+    if (shownFrames.empty() || shownFrames.back().litLeds != litLeds)
+    {
+        return fail("frame latched, lit leds", shownFrames.empty() ? 0 : shownFrames.back().litLeds);
+    }
+    if (shownFrames.back().timeShown != now)
+    {
+        return fail("SysLedTxDone after the frame is latched, us", (uint32_t)(now - shownFrames.back().timeShown));
+    }
+    return 0;
+}
+
+static int testTag(RoundLed &rLed)
+{
+    uint32_t start = micros();
+    rLed.tagFrame(TEST_TAG_1);
+    showFrame(rLed, 1);
+    return waitTxDone(rLed, 1, TEST_TAG_1, start + FRAME_TX_US);
+}
+
+static int testSkip(RoundLed &rLed)
+{
+    rLed.tagFrame(TEST_TAG_2);
+    showFrame(rLed, 1);
+    if (rLed.getFramesSkipped() != 1)
+    {
+        return fail("frames skipped", rLed.getFramesSkipped());
+    }
+    Message msg;
+    if (xQueueReceive(queue, &msg, pdMS_TO_TICKS(2)) == pdPASS)
+    {
+        return fail("SysLedTxDone of a skipped frame, tag", msg.lParam);
+    }
+    if (shownFrames.size() != 1)
+    {
+        return fail("frames latched", shownFrames.size());
+    }
+
+    uint32_t start = micros();
+    showFrame(rLed, 2);
+    return waitTxDone(rLed, 2, 0, start + FRAME_TX_US);
+}
+
+static int testCoalesce(RoundLed &rLed)
+{
+    uint32_t start = micros();
+    showFrame(rLed, 3); // on the wire
+    rLed.tagFrame(TEST_TAG_3);
+    showFrame(rLed, 4); // pending
+    rLed.tagFrame(TEST_TAG_4);
+    showFrame(rLed, 5); // replaces the pending frame, keeps its tag
+    if (rLed.isTxIdle() || rLed.getFramesSent() != 3)
+    {
+        return fail("frames sent, the coalesced frame pending", rLed.getFramesSent());
+    }
+    if (waitTxDone(rLed, 3, 0, start + FRAME_TX_US) || waitTxDone(rLed, 5, TEST_TAG_3, start + 2 * FRAME_TX_US))
+    {
+        return 1;
+    }
+    if (shownFrames.size() != 4)
+    {
+        return fail("frames latched", shownFrames.size());
+    }
+    if (!rLed.isTxIdle())
+    {
+        return fail("transmission idle", 0);
+    }
+    return 0;
+}
+
+static void testSetup(void)
+{
+    queue = xQueueCreateStatic(TEST_QUEUE_LENGTH, sizeof(Message), queueStorage, &queueBuffer);
+    FastLED.hostSetSink([](const CRGB *leds, int numLeds, int64_t timeShown)
+                        {
+                            uint16_t litLeds = 0;
+                            for (int i = 0; i < numLeds; i++)
+                            {
+                                litLeds += (leds[i].r || leds[i].g || leds[i].b) ? 1 : 0;
+                            }
+                            shownFrames.push_back(ShownFrame{litLeds, timeShown}); });
+}
+
+// runs once, then waits for ever
+static void testLoop(void)
+{
+    static RoundLed rLed(queue);
+    rLed.init();
+    testResult = testTag(rLed) || testSkip(rLed) || testCoalesce(rLed);
+    vTaskDelay(portMAX_DELAY);
+}
+
+int main(void)
+{
+    hostLogSetMaxLevel(DebugLogLevel::LVL_WARN);
+    hostArduinoStart(testSetup, testLoop);
+    hostSimRun(100 * 1000);
+
+    if (testResult < 0)
+    {
+        printf("FAIL the test did not run\n");
+        return 1;
+    }
+    return testResult;
+}
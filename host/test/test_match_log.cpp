@@ -0,0 +1,138 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <stdio.h>
+#include <Preferences.h>
+#include "game/GameEngine.h"
+#include "game/MatchLog.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// host test of MatchLog against the in-memory Preferences
+// a match longer than MATCH_LOG_SIZE records is saved, loaded and replayed from its base state,
+// a log with an out-of-range player or of another track is refused
+////////////////////////////////////////////////////////////////////////////////////////////
+#define TEST_TRACK_LENGTH 16
+
+static int fail(const char *what)
+{
+    printf("FAIL %s\n", what);
+    return 1;
+}
+
+// every player clicks once per round, Player1 once more every 32nd round: it laps the last player
+// after about 32 * TEST_TRACK_LENGTH rounds, more records than the log keeps even with 2 players
+static GamePlayer playLongMatch(MatchLog &log, uint8_t numPlayers, uint32_t &records)
+{
+    GameEngine engine(TEST_TRACK_LENGTH);
+    engine.reset(numPlayers);
+    log.begin();
+    log.append(MatchRecordStart, numPlayers, 0);
+    records = 1;
+    for (uint32_t round = 0; engine.getWinner() == PlayerNull; round++)
+    {
+        for (uint8_t p = 0; p < engine.getNumPlayers() && engine.getWinner() == PlayerNull; p++)
+        {
+            uint8_t clicks = (p == Player1 && (round % 32) == 0) ? 2 : 1;
+            for (uint8_t i = 0; i < clicks && engine.getWinner() == PlayerNull; i++)
+            {
+                log.append(MatchRecordInput, p, records++);
+                engine.advance((GamePlayer)p);
+            }
+        }
+    }
+    log.append(MatchRecordStop, engine.getWinner(), records++);
+    return engine.getWinner();
+}
+
+static int testLongMatch(uint8_t numPlayers)
+{
+    static MatchLog log(TEST_TRACK_LENGTH);
+    uint32_t records;
+    if (playLongMatch(log, numPlayers, records) != Player1)
+    {
+        return fail("long match: Player1 should win");
+    }
+    if (records <= MATCH_LOG_SIZE)
+    {
+        return fail("long match: shorter than the log");
+    }
+    if (!log.replay())
+    {
+        return fail("long match: replay from RAM");
+    }
+    if (!log.save())
+    {
+        return fail("long match: save");
+    }
+
+    static MatchLog loaded(TEST_TRACK_LENGTH);
+    if (!loaded.load() || !loaded.replay())
+    {
+        return fail("long match: replay from NVS");
+    }
+    return 0;
+}
+
+static int testInvalidRecord(void)
+{
+    static MatchLog log(TEST_TRACK_LENGTH);
+    log.begin();
+    log.append(MatchRecordStart, 2, 0);
+    log.append(MatchRecordInput, Player1, 1);
+    log.append(MatchRecordStop, PlayerNull, 2);
+    if (!log.save())
+    {
+        return fail("invalid record: save");
+    }
+
+    // corrupt the player of the input record in NVS
+    Preferences prefs;
+    MatchRecord records[3];
+    prefs.begin("matchlog", false);
+    prefs.getBytes("records", records, sizeof(records));
+    records[1].arg = 2; // Player3, not in the race of 2 players
+    prefs.putBytes("records", records, sizeof(records));
+    prefs.end();
+
+    static MatchLog loaded(TEST_TRACK_LENGTH);
+    if (!loaded.load())
+    {
+        return fail("invalid record: load");
+    }
+    if (loaded.replay())
+    {
+        return fail("invalid record: replay should be refused");
+    }
+    return 0;
+}
+
+static int testOtherTrack(void)
+{
+    static MatchLog log(TEST_TRACK_LENGTH + 1);
+    if (log.load())
+    {
+        return fail("other track: load should be refused");
+    }
+    return 0;
+}
+
+int main(void)
+{
+    return testLongMatch(2) || testLongMatch(GameEngine::getMaxPlayers()) || testInvalidRecord() || testOtherTrack();
+}
@@ -0,0 +1,201 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+#include "peripheral/button/GpioEdge.h"
+#include "util/MpscRing.h"
+#include "util/Trace.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// host stress test of the lock-free rings with real threads
+// SpscRing: one thread fires millions of GPIO edges into a GpioEdgeRing, the consumer drains it in
+//   batches as QueueMain does. every edge must come out once, in order and intact.
+// MpscRing: several threads write trace records into the Trace ring at once, checked the same way
+//   per producer.
+// a producer finding the ring full backs off and retries (unlike the ISR), so the ring keeps running
+// full and empty while every item still gets through; each rejected push must be counted as an overflow
+////////////////////////////////////////////////////////////////////////////////////////////
+#define STRESS_EDGES (2u << 20)
+#define STRESS_PRODUCERS 4
+#define STRESS_RECORDS_PER_PRODUCER (1u << 19)
+#define DRAIN_BATCH 16
+
+static int fail(const char *what, uint32_t expected, uint32_t actual)
+{
+    printf("FAIL %s: expected=%u, actual=%u\n", what, expected, actual);
+    return 1;
+}
+
+static int stressSpsc(void)
+{
+    static GpioEdgeRing ring;
+    std::atomic<bool> isDone(false);
+    uint32_t rejected = 0;
+
+    std::thread producer([&]()
+                         {
+                             for (uint32_t i = 0; i < STRESS_EDGES; i++)
+                             {
+                                 GpioEdge edge = {i, (uint8_t)(i % 64), (uint8_t)(i & 1)};
+                                 while (!ring.push(edge))
+                                 {
+                                     rejected++;
+                                     std::this_thread::sleep_for(std::chrono::microseconds(1));
+                                 }
+                             }
+                             isDone = true; });
+
+    uint32_t received = 0;
+    uint32_t next = 0;
+    for (;;)
+    {
+        bool isProducerDone = isDone; // read before draining: nothing is pushed after it
+        GpioEdge edge;
+        uint32_t count = 0;
+        while (count < DRAIN_BATCH && ring.pop(edge))
+        {
+            if (edge.pin != edge.time % 64 || edge.value != (edge.time & 1))
+            {
+                producer.join();
+                return fail("spsc edge intact", edge.time % 64, edge.pin);
+            }
+            if (edge.time != next)
+            {
+                producer.join();
+                return fail("spsc edge order", next, edge.time);
+            }
+            next++;
+            count++;
+        }
+        received += count;
+        if (count == 0)
+        {
+            if (isProducerDone)
+            {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    printf("{\"test\":\"spscRing\",\"fired\":%u,\"received\":%u,\"overflow\":%u}\n", STRESS_EDGES, received, ring.overflow());
+    if (received != STRESS_EDGES)
+    {
+        return fail("spsc received", STRESS_EDGES, received);
+    }
+    if (ring.overflow() != rejected)
+    {
+        return fail("spsc overflow", rejected, ring.overflow());
+    }
+    return 0;
+}
+
+static int stressMpsc(void)
+{
+    static MpscRing<TraceRecord, TRACE_RING_SIZE> ring;
+    std::atomic<uint32_t> rejected(0);
+    std::atomic<uint32_t> producersDone(0);
+
+    std::vector<std::thread> producers;
+    for (uint16_t p = 0; p < STRESS_PRODUCERS; p++)
+    {
+        producers.emplace_back([&, p]()
+                               {
+                                   uint32_t count = 0;
+                                   for (uint32_t i = 0; i < STRESS_RECORDS_PER_PRODUCER; i++)
+                                   {
+                                       while (!ring.push(TraceRecord{i, p, (uint16_t)i, ~i}))
+                                       {
+                                           count++;
+                                           std::this_thread::sleep_for(std::chrono::microseconds(1));
+                                       }
+                                   }
+                                   rejected += count;
+                                   producersDone++; });
+    }
+
+    uint32_t received = 0;
+    uint32_t next[STRESS_PRODUCERS] = {0};
+    int rc = 0;
+    for (;;)
+    {
+        bool isProducerDone = (producersDone == STRESS_PRODUCERS);
+        TraceRecord record;
+        uint32_t count = 0;
+        while (count < DRAIN_BATCH && ring.pop(record))
+        {
+            if (rc == 0)
+            {
+                if (record.id >= STRESS_PRODUCERS || record.arg0 != (uint16_t)record.time || record.arg1 != ~record.time)
+                {
+                    rc = fail("mpsc record intact", record.time, record.arg1);
+                }
+                else if (record.time != next[record.id])
+                {
+                    rc = fail("mpsc record order", next[record.id], record.time);
+                }
+                else
+                {
+                    next[record.id] = record.time + 1;
+                }
+            }
+            count++;
+        }
+        received += count;
+        if (count == 0)
+        {
+            if (isProducerDone)
+            {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread &producer : producers)
+    {
+        producer.join();
+    }
+    if (rc)
+    {
+        return rc;
+    }
+
+    uint32_t total = STRESS_PRODUCERS * STRESS_RECORDS_PER_PRODUCER;
+    printf("{\"test\":\"mpscRing\",\"producers\":%u,\"fired\":%u,\"received\":%u,\"overflow\":%u}\n",
+           STRESS_PRODUCERS, total, received, ring.overflow());
+    if (received != total)
+    {
+        return fail("mpsc received", total, received);
+    }
+    if (ring.overflow() != rejected)
+    {
+        return fail("mpsc overflow", rejected, ring.overflow());
+    }
+    return 0;
+}
+
+int main(void)
+{
+    return stressSpsc() || stressMpsc();
+}
@@ -0,0 +1,146 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <DebugLog.h>
+#include <HostSim.h>
+#include "AppEvent.h"
+#include "../tools/TraceDecoder.h"
+#include "./SimScript.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// round trip of the binary trace: records encoded as Trace.cpp writes them are decoded back by the host decoder,
+// in a stream mixed with the text of the log; then the sketch runs on the simulated target with Serial captured
+// and a scripted click must come back as its TraceUserClick record, with the log lines intact
+////////////////////////////////////////////////////////////////////////////////////////////
+static std::vector<TraceRecord> records;
+static std::vector<std::string> lines;
+
+static TraceDecoder decoder([](const TraceRecord &record)
+                            { records.push_back(record); },
+                            [](const std::string &line)
+                            { lines.push_back(line); });
+
+static int fail(const char *what)
+{
+    printf("FAIL %s\n", what);
+    return 1;
+}
+
+static bool isEqual(const TraceRecord &a, const TraceRecord &b)
+{
+    return a.time == b.time && a.id == b.id && a.arg0 == b.arg0 && a.arg1 == b.arg1;
+}
+
+// every byte value of a frame, the sync byte included, survives; a record inside a line leaves the line whole
+static int testEncodeDecode(void)
+{
+    static const TraceRecord sent[] = {
+        {0, TraceUserClick, 0, 0},
+        {0xA5A5A5A5, TraceGesture, 0xA5A5, 0xA5A5A5A5},
+        {0xFFFFFFFF, TraceDropped, 0xFFFF, 0xFFFFFFFF},
+        {0x01020304, TraceOvertake, 0x0506, 0x0708090A},
+    };
+    static const char textBefore[] = "[TRACE] half a ";
+    static const char textAfter[] = "line\n";
+
+    uint8_t frame[TRACE_FRAME_SIZE];
+    decoder.feed((const uint8_t *)textBefore, strlen(textBefore));
+    for (const TraceRecord &record : sent)
+    {
+        traceEncode(record, frame);
+        decoder.feed(frame, sizeof(frame));
+    }
+    decoder.feed((const uint8_t *)textAfter, strlen(textAfter));
+
+    if (records.size() != sizeof(sent) / sizeof(sent[0]))
+    {
+        return fail("records decoded");
+    }
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        if (!isEqual(records[i], sent[i]))
+        {
+            return fail("record differs after the round trip");
+        }
+    }
+    if (lines.size() != 1 || lines[0] != "[TRACE] half a line")
+    {
+        return fail("line broken by the records");
+    }
+
+    char text[128];
+    traceToText(TraceRecord{605000, TraceUserClick, ButtonIdPlayer1, 604000}, text, sizeof(text));
+    if (strcmp(text, "[605000] UserClick: button=2, timestamp=604000") != 0)
+    {
+        printf("%s\n", text);
+        return fail("text of a record");
+    }
+    traceToText(TraceRecord{1, TraceDropped, 0, 3}, text, sizeof(text));
+    if (strcmp(text, "[1] Trace: dropped=3") != 0)
+    {
+        printf("%s\n", text);
+        return fail("text of a record without arg0");
+    }
+    return 0;
+}
+
+// Serial of the simulated target: the click of Player1 is traced with the time of its release edge
+static int testSketch(void)
+{
+    records.clear();
+    lines.clear();
+    Serial.hostSetSink([](const uint8_t *data, size_t size)
+                       { decoder.feed(data, size); });
+    scriptBoot();
+    scriptStartGame();
+    scriptSetButton(scriptPlayerPins[0], true);
+    hostSimRun(30 * 1000);
+    uint32_t timeRelease = (uint32_t)hostSimTime();
+    scriptSetButton(scriptPlayerPins[0], false);
+    hostSimRun(30 * 1000);
+    Serial.hostSetSink(nullptr);
+
+    bool isClickFound = false;
+    for (const TraceRecord &record : records)
+    {
+        char text[128];
+        traceToText(record, text, sizeof(text));
+        printf("%s\n", text);
+        isClickFound |= record.id == TraceUserClick && record.arg0 == ButtonIdPlayer1 && record.arg1 == timeRelease;
+    }
+    if (!isClickFound)
+    {
+        return fail("no TraceUserClick of Player1 at its release");
+    }
+    if (lines.empty() || lines[0] != "initialized Serial")
+    {
+        return fail("log lines around the records");
+    }
+    return 0;
+}
+
+int main(void)
+{
+    hostLogSetMaxLevel(DebugLogLevel::LVL_WARN);
+    return testEncodeDecode() || testSketch();
+}
@@ -0,0 +1,87 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <functional>
+#include <string>
+#include "util/Trace.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// splits the output of Serial into the lines of the log and the binary trace records written between them
+// (see util/Trace.h): bytes are fed as they arrive, a record is handed over once its frame is complete,
+// a line once its '\n' arrives. a record written in the middle of a line does not break the line.
+// the stream is read from boot: a capture starting inside a frame decodes garbage until the next sync byte
+/////////////////////////////////////////////////////////////////////////////
+class TraceDecoder
+{
+public:
+    typedef std::function<void(const TraceRecord &record)> RecordSink;
+    typedef std::function<void(const std::string &line)> LineSink;
+
+    TraceDecoder(RecordSink onRecord, LineSink onLine) : _onRecord(onRecord),
+                                                         _onLine(onLine),
+                                                         _frameSize(0)
+    {
+    }
+
+    void feed(const uint8_t *data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            uint8_t value = data[i];
+            if (_frameSize || value == TRACE_FRAME_SYNC)
+            {
+                _frame[_frameSize++] = value;
+                if (_frameSize == TRACE_FRAME_SIZE)
+                {
+                    TraceRecord record;
+                    traceDecode(_frame, record);
+                    _onRecord(record);
+                    _frameSize = 0;
+                }
+            }
+            else if (value == '\n')
+            {
+                _onLine(_line);
+                _line.clear();
+            }
+            else if (value != '\r')
+            {
+                _line += (char)value;
+            }
+        }
+    }
+
+    // the last line, if not terminated
+    void flush(void)
+    {
+        if (!_line.empty())
+        {
+            _onLine(_line);
+            _line.clear();
+        }
+    }
+
+private:
+    RecordSink _onRecord;
+    LineSink _onLine;
+    uint8_t _frame[TRACE_FRAME_SIZE];
+    uint8_t _frameSize; // bytes of the frame received so far, 0 outside a frame
+    std::string _line;
+};
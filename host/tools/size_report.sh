@@ -0,0 +1,36 @@
+#!/bin/sh
+# size report of the release log preset: code and data size of each module of the app compiled with the
+# default log thresholds (first archive) and with APP_LOG_RELEASE (second archive), one JSON object per line.
+# host object sizes, not ESP32-C3 flash: the difference shows what the log calls cost, not the sketch size.
+# fails if a module is larger in the release build, or the release build is not smaller in total
+#
+# usage: size_report.sh <size tool> <default archive> <release archive>
+set -e
+SIZE="$1"
+{
+    "$SIZE" "$2" | awk -v build=default 'NR > 1 { print build, $6, $1 + $2 }'
+    "$SIZE" "$3" | awk -v build=release 'NR > 1 { print build, $6, $1 + $2 }'
+} | awk '
+    $1 == "default" { base[$2] = $3; order[n++] = $2 }
+    $1 == "release" { release[$2] = $3 }
+    END {
+        status = 0
+        for (i = 0; i < n; i++) {
+            m = order[i]
+            name = m
+            sub(/\.cpp\.o$/, "", name)
+            printf("{\"module\":\"%s\",\"defaultBytes\":%d,\"releaseBytes\":%d,\"savedBytes\":%d}\n", name, base[m], release[m], base[m] - release[m])
+            totalBase += base[m]
+            totalRelease += release[m]
+            if (release[m] > base[m]) {
+                printf("FAIL %s is larger in the release build\n", name)
+                status = 1
+            }
+        }
+        printf("{\"module\":\"total\",\"defaultBytes\":%d,\"releaseBytes\":%d,\"savedBytes\":%d}\n", totalBase, totalRelease, totalBase - totalRelease)
+        if (totalRelease >= totalBase) {
+            print "FAIL the release build is not smaller"
+            status = 1
+        }
+        exit status
+    }'
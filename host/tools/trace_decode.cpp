@@ -0,0 +1,63 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <stdio.h>
+#include "./TraceDecoder.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// decodes a capture of the Serial output of the target (APP_TRACE) into text: the lines of the log as they
+// are, each trace record formatted by traceToText() with the decode table of Trace.cpp
+//
+// usage:
+//   trace_decode [capture]     reads stdin without a file, e.g. a raw capture of the serial port:
+//   stty -F /dev/ttyACM0 115200 raw && cat /dev/ttyACM0 | trace_decode
+////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[])
+{
+    FILE *input = stdin;
+    if (argc > 1 && (input = fopen(argv[1], "rb")) == nullptr)
+    {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    TraceDecoder decoder(
+        [](const TraceRecord &record)
+        {
+            char text[128];
+            traceToText(record, text, sizeof(text));
+            puts(text);
+        },
+        [](const std::string &line)
+        { puts(line.c_str()); });
+
+    uint8_t buffer[256];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), input)) > 0)
+    {
+        decoder.feed(buffer, size);
+        fflush(stdout);
+    }
+    decoder.flush();
+    if (input != stdin)
+    {
+        fclose(input);
+    }
+    return 0;
+}
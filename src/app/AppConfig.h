@@ -0,0 +1,101 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+// button input mode
+//
+// by default every GPIO edge (including contact bounce) raises an interrupt.
+// define APP_BUTTON_POLLING to sample the buttons from a software timer instead, see ButtonPoller.h;
+// the timer stops while the game is stopped and idle.
+// a double click on button "Game" prints the cost of the selected mode (calls, edges, CPU time).
+/////////////////////////////////////////////////////////////////////////////
+// #define APP_BUTTON_POLLING
+
+/////////////////////////////////////////////////////////////////////////////
+// number of players on the ring, 2 to 8
+// each player has a button: one GPIO per player is listed in PINS_SW_PLAYER in pins.h
+/////////////////////////////////////////////////////////////////////////////
+#ifndef GAME_NUM_PLAYERS
+#define GAME_NUM_PLAYERS 2
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// binary trace of hot paths (clicks, gestures, game state), see util/Trace.h
+// undefine APP_TRACE to compile every TRACE() out
+/////////////////////////////////////////////////////////////////////////////
+#define APP_TRACE
+
+/////////////////////////////////////////////////////////////////////////////
+// brightness of the LEDs at boot, 0 (off) to 255 (full current), after gamma correction
+/////////////////////////////////////////////////////////////////////////////
+#define LED_BRIGHTNESS 255
+
+/////////////////////////////////////////////////////////////////////////////
+// current budget of the LEDs in mA, a frame estimated above it is scaled down before transmission
+// keep it below the USB supply capability minus the draw of the board, 0 disables the limiter
+/////////////////////////////////////////////////////////////////////////////
+#define LED_POWER_BUDGET_MA 400
+
+/////////////////////////////////////////////////////////////////////////////
+// animation of the LEDs while a game runs, is paused or is won, see peripheral/LedAnimation.h
+// frames are composed at LED_FRAME_RATE (frames/s); a frame composed in more than LED_FRAME_BUDGET_US
+// halves the rate (down to 1/8), it is restored once frames take less than a quarter of the budget
+/////////////////////////////////////////////////////////////////////////////
+#define LED_FRAME_RATE 50
+#define LED_FRAME_BUDGET_US 2000
+
+/////////////////////////////////////////////////////////////////////////////
+// benchmark of the click path, run once at boot, results printed as JSON lines, see ThreadGameBenchmark.cpp
+// for dedicated benchmark builds only: the LEDs show synthetic games while it runs
+/////////////////////////////////////////////////////////////////////////////
+// #define APP_BENCHMARK
+
+/////////////////////////////////////////////////////////////////////////////
+// sizes of static message queues and task stacks
+//
+// a double click on button "Game" prints the peak queue occupancy and the stack high-water mark of each task.
+// record these worst cases after a stress session (e.g. both players clicking as fast as possible),
+// update the PROFILE_* values below and define APP_SIZE_FROM_PROFILE to size the buffers from them.
+/////////////////////////////////////////////////////////////////////////////
+// #define APP_SIZE_FROM_PROFILE
+
+// recorded worst cases: queue peak in number of messages, stack in bytes
+#define PROFILE_QUEUE_MAIN_QUEUE_PEAK 8
+#define PROFILE_THREAD_GAME_QUEUE_PEAK 16
+#define PROFILE_THREAD_GAME_STACK_USED 2048
+#define PROFILE_LED_TX_STACK_USED 1024
+
+// margin added on top of a recorded worst case: +50%, plus a fixed 4 messages / 512 bytes on top of that
+// (not a floor: the constant is always added, so a small peak keeps some headroom)
+#define SIZE_QUEUE_WITH_MARGIN(peak) ((peak) + (peak) / 2 + 4)
+#define SIZE_STACK_WITH_MARGIN(used) ((used) + (used) / 2 + 512)
+
+#ifdef APP_SIZE_FROM_PROFILE
+#define QUEUE_MAIN_QUEUE_SIZE SIZE_QUEUE_WITH_MARGIN(PROFILE_QUEUE_MAIN_QUEUE_PEAK)
+#define THREAD_GAME_QUEUE_SIZE SIZE_QUEUE_WITH_MARGIN(PROFILE_THREAD_GAME_QUEUE_PEAK)
+#define THREAD_GAME_STACK_SIZE SIZE_STACK_WITH_MARGIN(PROFILE_THREAD_GAME_STACK_USED)
+#define LED_TX_STACK_SIZE SIZE_STACK_WITH_MARGIN(PROFILE_LED_TX_STACK_USED)
+#else
+#define QUEUE_MAIN_QUEUE_SIZE 2048
+#define THREAD_GAME_QUEUE_SIZE 128
+#define THREAD_GAME_STACK_SIZE 4096
+#define LED_TX_STACK_SIZE 2048
+#endif
@@ -27,9 +27,11 @@ namespace ardufreertos
     class MessageQueue;
     class ThreadBase;
 };
+class PowerManager;
 
 typedef struct _AppContext
 {
     ardufreertos::MessageQueue *queueMain;
     ardufreertos::ThreadBase *threadGame;
+    PowerManager *powerManager;
 } AppContext;
@@ -25,11 +25,11 @@ enum AppEvent : int16_t
     /////////////////////////////////////////////////////////////////////////////
     EventNull = 0,
 
-    EventGpioISR = 10, // iParam=pin, uParam=value, lParam=millis()
+    EventGpioISR = 10, // GPIO edges are pending in DebounceButton's edge ring
     EventSystem,       // iParam=SystemTriggerSource
 
     /////////////////////////////////////////////////////////////////////////////
-    EventUser = 500, // iParam=<UserTriggerSource>, uParam=<ButtonId>
+    EventUser = 500, // iParam=<UserTriggerSource>, uParam=<ButtonId>, lParam=micros() of GPIO ISR (0 if none)
 
     /////////////////////////////////////////////////////////////////////////////
 };
@@ -37,10 +37,8 @@ enum AppEvent : int16_t
 enum SystemTriggerSource : int16_t
 {
     SysInitDone = 0,
-    SysSoftwareTimer,     // lParam=xTimer:uint32_t
-    SysButtonClick,       // uParam=pin number
-    SysButtonDoubleClick, // uParam=pin number
-    SysButtonLongPress,   // uParam=pin number
+    SysSoftwareTimer,     // uParam=<TimerId>
+    SysLedTxDone,         // RoundLed finished transmitting a frame, lParam=ISR timestamp of its earliest click (0 if none)
 };
 
 typedef enum _UserTriggerSource : int16_t
@@ -57,4 +55,18 @@ typedef enum _ButtonId : int16_t
     ButtonIdGame,
     ButtonIdPlayer1,
     ButtonIdPlayer2,
+    ButtonIdPlayer3, // ButtonIdPlayer3..8: GAME_NUM_PLAYERS > 2 only
+    ButtonIdPlayer4,
+    ButtonIdPlayer5,
+    ButtonIdPlayer6,
+    ButtonIdPlayer7,
+    ButtonIdPlayer8,
 } ButtonId;
+
+typedef enum _TimerId : uint8_t
+{
+    TimerIdNull = 0,
+    TimerIdDebounce,
+    TimerId1Hz,
+    TimerIdFrame,
+} TimerId;
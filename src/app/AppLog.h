@@ -27,3 +27,48 @@
 
 #define DefaultLogLevel (DebugLogLevel::LVL_TRACE)
 // #define DefaultLogLevel (DebugLogLevel::LVL_NONE)
+
+/////////////////////////////////////////////////////////////////////////////
+// compile-time log threshold of each module
+// a LOG_xxx call above the threshold of its module compiles to nothing, its arguments are not evaluated.
+// the runtime level (DefaultLogLevel) still filters what is left. see AppLogModule.h
+/////////////////////////////////////////////////////////////////////////////
+#define APP_LOG_LEVEL_NONE 0
+#define APP_LOG_LEVEL_ERROR 1
+#define APP_LOG_LEVEL_WARN 2
+#define APP_LOG_LEVEL_INFO 3
+#define APP_LOG_LEVEL_DEBUG 4
+#define APP_LOG_LEVEL_TRACE 5
+
+// release preset: every module at APP_LOG_LEVEL_NONE, no log call is compiled.
+// define it here or on the compiler command line (-DAPP_LOG_RELEASE), the host build has it as app_host_release
+// #define APP_LOG_RELEASE
+
+#ifdef APP_LOG_RELEASE
+#define APP_LOG_LEVEL_QUEUE_MAIN APP_LOG_LEVEL_NONE
+#define APP_LOG_LEVEL_THREAD_GAME APP_LOG_LEVEL_NONE
+#define APP_LOG_LEVEL_DEBOUNCE APP_LOG_LEVEL_NONE
+#define APP_LOG_LEVEL_ROUND_LED APP_LOG_LEVEL_NONE
+#define APP_LOG_LEVEL_GAME APP_LOG_LEVEL_NONE
+#define APP_LOG_LEVEL_POWER APP_LOG_LEVEL_NONE
+#endif
+
+// defaults, a threshold can also be set on the compiler command line, e.g. -DAPP_LOG_LEVEL_GAME=2
+#ifndef APP_LOG_LEVEL_QUEUE_MAIN
+#define APP_LOG_LEVEL_QUEUE_MAIN APP_LOG_LEVEL_TRACE
+#endif
+#ifndef APP_LOG_LEVEL_THREAD_GAME
+#define APP_LOG_LEVEL_THREAD_GAME APP_LOG_LEVEL_TRACE
+#endif
+#ifndef APP_LOG_LEVEL_DEBOUNCE
+#define APP_LOG_LEVEL_DEBOUNCE APP_LOG_LEVEL_TRACE
+#endif
+#ifndef APP_LOG_LEVEL_ROUND_LED
+#define APP_LOG_LEVEL_ROUND_LED APP_LOG_LEVEL_TRACE
+#endif
+#ifndef APP_LOG_LEVEL_GAME
+#define APP_LOG_LEVEL_GAME APP_LOG_LEVEL_TRACE
+#endif
+#ifndef APP_LOG_LEVEL_POWER
+#define APP_LOG_LEVEL_POWER APP_LOG_LEVEL_TRACE
+#endif
@@ -0,0 +1,56 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// no #pragma once: each module includes this file last, after defining its threshold
+//
+// usage (last include of a .cpp):
+//   #define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_QUEUE_MAIN
+//   #include "../AppLogModule.h"
+#include "./AppLog.h"
+
+#ifndef APP_LOG_MODULE_LEVEL
+#error "define APP_LOG_MODULE_LEVEL before including AppLogModule.h"
+#endif
+
+#if APP_LOG_MODULE_LEVEL < APP_LOG_LEVEL_TRACE
+#undef LOG_TRACE
+#define LOG_TRACE(...) ((void)0)
+#endif
+
+#if APP_LOG_MODULE_LEVEL < APP_LOG_LEVEL_DEBUG
+#undef LOG_DEBUG
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if APP_LOG_MODULE_LEVEL < APP_LOG_LEVEL_INFO
+#undef LOG_INFO
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if APP_LOG_MODULE_LEVEL < APP_LOG_LEVEL_WARN
+#undef LOG_WARN
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if APP_LOG_MODULE_LEVEL < APP_LOG_LEVEL_ERROR
+#undef LOG_ERROR
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#undef APP_LOG_MODULE_LEVEL
@@ -0,0 +1,99 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "./ArduProfFreeRTOS.h"
+#include "./AppEvent.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// typed events carried in ArduProf's Message
+// each type fixes the AppEvent and the meaning of iParam/uParam/lParam, so a parameter of the wrong
+// type or in the wrong place is rejected at compile time
+//
+// usage:
+//   postEvent(ctx->threadGame, EVENT_ARGS(UserInput{UserClick, ButtonIdPlayer1, time}));
+//   UserInput input = UserInput::decode(msg);
+/////////////////////////////////////////////////////////////////////////////
+typedef struct _EventParams
+{
+    int16_t event;
+    int16_t iParam;
+    uint16_t uParam;
+    uint32_t lParam;
+} EventParams;
+
+// EventGpioISR: edges are pending in DebounceButton's edge ring
+typedef struct _GpioEdgeReady
+{
+    constexpr EventParams encode(void) const
+    {
+        return EventParams{EventGpioISR, 0, 0, 0};
+    }
+} GpioEdgeReady;
+
+// EventSystem / SysSoftwareTimer
+typedef struct _TimerTick
+{
+    TimerId id;
+
+    constexpr EventParams encode(void) const
+    {
+        return EventParams{EventSystem, SysSoftwareTimer, id, 0};
+    }
+    static _TimerTick decode(const Message &msg)
+    {
+        return _TimerTick{(TimerId)(msg.uParam)};
+    }
+} TimerTick;
+
+// EventSystem / SysLedTxDone
+typedef struct _LedTxDone
+{
+    uint32_t timestamp; // ISR timestamp of the earliest click drawn into the transmitted frame, 0 if none
+
+    constexpr EventParams encode(void) const
+    {
+        return EventParams{EventSystem, SysLedTxDone, 0, timestamp};
+    }
+    static _LedTxDone decode(const Message &msg)
+    {
+        return _LedTxDone{msg.lParam};
+    }
+} LedTxDone;
+
+// EventUser
+typedef struct _UserInput
+{
+    UserTriggerSource source;
+    ButtonId button;
+    uint32_t timestamp; // micros() of GPIO ISR, 0 if none
+
+    constexpr EventParams encode(void) const
+    {
+        return EventParams{EventUser, source, (uint16_t)button, timestamp};
+    }
+    static _UserInput decode(const Message &msg)
+    {
+        return _UserInput{(UserTriggerSource)(msg.iParam), (ButtonId)(msg.uParam), msg.lParam};
+    }
+} UserInput;
+
+// expands a typed event to the (event, iParam, uParam, lParam) arguments of
+// postEvent() / sendMessageToTask() / sendMessageFromIsrToTask()
+#define EVENT_ARGS(...) (__VA_ARGS__).encode().event, (__VA_ARGS__).encode().iParam, (__VA_ARGS__).encode().uParam, (__VA_ARGS__).encode().lParam
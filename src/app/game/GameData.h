@@ -21,11 +21,9 @@
 #include <Arduino.h>
 #include "./GameState.h"
 #include "./GamePlayer.h"
-#include "./TimeSlotState.h"
 
 typedef struct _GameData
 {
     GameState state;
     GamePlayer winner;
-    TimeSlotState timeSlotState;
 } GameData;
\ No newline at end of file
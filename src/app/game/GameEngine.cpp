@@ -0,0 +1,116 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <string.h>
+#include "./GameEngine.h"
+
+#define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_GAME
+#include "../AppLogModule.h"
+
+#define CLICKS_PER_STEP 1 // numer of clicks to advance 1 step
+
+GameEngine::GameEngine(uint16_t trackLength) : _trackLength(trackLength)
+{
+    reset();
+}
+
+void GameEngine::reset(uint8_t numPlayers)
+{
+    _numPlayers = (numPlayers >= 2 && numPlayers <= GAME_NUM_PLAYERS) ? numPlayers : GAME_NUM_PLAYERS;
+    memset(&_players, 0, sizeof(_players));
+    _leader = Player1;
+    _last = Player1;
+    _winner = PlayerNull;
+    _overtakes = 0;
+}
+
+GameSnapshot GameEngine::getSnapshot(void) const
+{
+    return GameSnapshot{_numPlayers, _players, _leader, _last, _winner, _overtakes};
+}
+
+bool GameEngine::restore(const GameSnapshot &snapshot)
+{
+    const PlayersData &players = snapshot.players;
+    uint8_t numPlayers = snapshot.numPlayers;
+    if (numPlayers < 2 || numPlayers > GAME_NUM_PLAYERS || snapshot.leader >= numPlayers || snapshot.last >= numPlayers ||
+        (snapshot.winner != PlayerNull && snapshot.winner >= numPlayers))
+    {
+        return false;
+    }
+    for (uint8_t p = 0; p < numPlayers; p++)
+    {
+        if (players.countClick[p] >= CLICKS_PER_STEP || players.position[p] != players.distance[p] % _trackLength ||
+            players.distance[p] > players.distance[snapshot.leader] || players.distance[p] < players.distance[snapshot.last])
+        {
+            return false;
+        }
+    }
+
+    _numPlayers = numPlayers;
+    _players = players;
+    _leader = snapshot.leader;
+    _last = snapshot.last;
+    _winner = snapshot.winner;
+    _overtakes = snapshot.overtakes;
+    return true;
+}
+
+bool GameEngine::advance(GamePlayer player)
+{
+    if (player >= _numPlayers || _winner != PlayerNull || ++_players.countClick[player] < CLICKS_PER_STEP)
+    {
+        return false;
+    }
+
+    _players.countClick[player] = 0;
+    _players.position[player] = (_players.position[player] < (_trackLength - 1)) ? _players.position[player] + 1 : 0;
+    uint32_t distance = ++_players.distance[player];
+
+    // only the player who moved can pass the leader; the leader changes only when strictly passed
+    if (player != _leader && distance > _players.distance[_leader])
+    {
+        _leader = player;
+        _overtakes++;
+    }
+
+    // the last player changes only when it moves itself
+    if (player == _last)
+    {
+        updateLast();
+    }
+
+    // distances grow by one step at a time, so the first player to get a full loop ahead of the last is the mover
+    if (distance - _players.distance[_last] >= _trackLength)
+    {
+        _winner = player;
+    }
+    return true;
+}
+
+void GameEngine::updateLast(void)
+{
+    const uint32_t *distance = _players.distance;
+    GamePlayer last = _last;
+    for (uint8_t p = 0; p < _numPlayers; p++)
+    {
+        last = (distance[p] < distance[last]) ? (GamePlayer)p : last;
+    }
+    _last = last;
+}
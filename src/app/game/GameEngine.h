@@ -0,0 +1,97 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "../ArduProfFreeRTOS.h"
+#include "./GamePlayer.h"
+#include "./PlayerData.h"
+
+// complete state of a GameEngine, restored to replay a match from the middle (see MatchLog)
+typedef struct _GameSnapshot
+{
+    uint8_t numPlayers;
+    PlayersData players;
+    GamePlayer leader;
+    GamePlayer last;
+    GamePlayer winner;
+    uint32_t overtakes;
+} GameSnapshot;
+
+/////////////////////////////////////////////////////////////////////////////
+// race of 2 to GAME_NUM_PLAYERS players on a circular track of trackLength steps
+// a player wins by lapping another player
+// overtakes and the winner are detected incrementally on each step of a player, by comparing distances
+/////////////////////////////////////////////////////////////////////////////
+class GameEngine
+{
+public:
+    GameEngine(uint16_t trackLength);
+
+    static constexpr uint8_t getMaxPlayers(void)
+    {
+        return GAME_NUM_PLAYERS;
+    }
+    // players in the current race: Player1 to Player1 + numPlayers - 1
+    uint8_t getNumPlayers(void) const
+    {
+        return _numPlayers;
+    }
+
+    // start a race of numPlayers (2 to getMaxPlayers(), else getMaxPlayers())
+    void reset(uint8_t numPlayers = GAME_NUM_PLAYERS);
+
+    GameSnapshot getSnapshot(void) const;
+    // returns false, and leaves the engine unchanged, if the snapshot is not a state of this track
+    bool restore(const GameSnapshot &snapshot);
+
+    // one click of player, returns true if the player moved; ignored once there is a winner,
+    // or if player is not in the race
+    bool advance(GamePlayer player);
+
+    // PlayerNull until a player has lapped another one
+    GamePlayer getWinner(void) const
+    {
+        return _winner;
+    }
+
+    uint16_t getPosition(GamePlayer player) const
+    {
+        return _players.position[player];
+    }
+    GamePlayer getLeader(void) const
+    {
+        return _leader;
+    }
+    uint32_t getOvertakes(void) const
+    {
+        return _overtakes;
+    }
+
+private:
+    const uint16_t _trackLength;
+    uint8_t _numPlayers;
+    PlayersData _players;
+
+    void updateLast(void);
+
+    GamePlayer _leader; // largest distance
+    GamePlayer _last;   // smallest distance
+    GamePlayer _winner;
+    uint32_t _overtakes; // number of leader changes since reset()
+};
@@ -19,11 +19,22 @@
  */
 #pragma once
 #include <Arduino.h>
+#include "../AppConfig.h" // GAME_NUM_PLAYERS
 
-typedef enum _GamePlayer
+// a player is identified by its button: ButtonIdPlayer1 + player
+
+typedef enum _GamePlayer : uint8_t
 {
-    PlayerNull = 0,
-    Player1,
+    Player1 = 0,
     Player2,
-    NumPlayer,
-} GamePlayer;
\ No newline at end of file
+    Player3,
+    Player4,
+    Player5,
+    Player6,
+    Player7,
+    Player8,
+    PlayerMaxValue,
+    PlayerNull = 0xFF,
+} GamePlayer;
+
+static_assert(GAME_NUM_PLAYERS >= 2 && GAME_NUM_PLAYERS <= PlayerMaxValue, "GAME_NUM_PLAYERS must be 2..8");
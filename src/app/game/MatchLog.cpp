@@ -0,0 +1,175 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <string.h>
+#include <algorithm>
+#include <Preferences.h>
+#include "./MatchLog.h"
+
+#define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_GAME
+#include "../AppLogModule.h"
+
+#define NVS_NAMESPACE "matchlog"
+#define REPLAY_ROUNDS 100 // the match is replayed this many times to get a measurable duration
+
+MatchLog::MatchLog(uint16_t trackLength) : _head(0),
+                                           _count(0),
+                                           _dropped(0),
+                                           _trackLength(trackLength),
+                                           _base(trackLength)
+{
+}
+
+void MatchLog::begin(void)
+{
+    _head = 0;
+    _count = 0;
+    _dropped = 0;
+    _base.reset();
+}
+
+// oldest record first at index 0
+void MatchLog::linearize(void)
+{
+    if (_count == MATCH_LOG_SIZE && _head != 0)
+    {
+        std::rotate(_records, _records + _head, _records + MATCH_LOG_SIZE);
+    }
+    _head = _count % MATCH_LOG_SIZE;
+}
+
+// numPlayers: players of the race the record belongs to
+bool MatchLog::isValid(const MatchRecord &record, uint8_t numPlayers)
+{
+    switch (record.type)
+    {
+    case MatchRecordInput:
+        return record.arg < numPlayers;
+    case MatchRecordStop:
+        return record.arg < numPlayers || record.arg == PlayerNull;
+    case MatchRecordStart:
+        return record.arg >= 2 && record.arg <= GameEngine::getMaxPlayers();
+    case MatchRecordPause:
+    case MatchRecordResume:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool MatchLog::save(void)
+{
+    linearize();
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false))
+    {
+        LOG_WARN("MatchLog: failed to open NVS");
+        return false;
+    }
+    GameSnapshot base = _base.getSnapshot();
+    prefs.putUInt("players", GAME_NUM_PLAYERS);
+    prefs.putUInt("track", _trackLength);
+    prefs.putUInt("dropped", _dropped);
+    size_t sizeBase = prefs.putBytes("base", &base, sizeof(base));
+    size_t size = prefs.putBytes("records", _records, _count * sizeof(MatchRecord));
+    prefs.end();
+    return sizeBase == sizeof(base) && size == _count * sizeof(MatchRecord);
+}
+
+bool MatchLog::load(void)
+{
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true))
+    {
+        return false;
+    }
+    // a log of another configuration cannot be replayed by this engine
+    GameSnapshot base;
+    bool isLoaded = (prefs.getUInt("players", 0) == GAME_NUM_PLAYERS) && (prefs.getUInt("track", 0) == _trackLength) &&
+                    (prefs.getBytes("base", &base, sizeof(base)) == sizeof(base)) && _base.restore(base);
+    if (isLoaded)
+    {
+        _dropped = prefs.getUInt("dropped", 0);
+        size_t size = prefs.getBytes("records", _records, sizeof(_records));
+        _count = size / sizeof(MatchRecord);
+        _head = _count % MATCH_LOG_SIZE;
+    }
+    else
+    {
+        begin();
+    }
+    prefs.end();
+    return isLoaded;
+}
+
+bool MatchLog::replay(void)
+{
+    linearize();
+    if (_count == 0)
+    {
+        PRINTLN("MatchLog: no match to replay");
+        return false;
+    }
+
+    // records come from NVS: check them all before any reaches the engine
+    GamePlayer recordedWinner = PlayerNull;
+    uint8_t numPlayers = _base.getNumPlayers();
+    for (uint16_t i = 0; i < _count; i++)
+    {
+        const MatchRecord &record = _records[i];
+        if (!isValid(record, numPlayers))
+        {
+            PRINTLN("MatchLog: invalid record ", i, ": type=", record.type, ", arg=", record.arg);
+            return false;
+        }
+        if (record.type == MatchRecordStart)
+        {
+            numPlayers = record.arg;
+        }
+        else if (record.type == MatchRecordStop)
+        {
+            recordedWinner = (GamePlayer)(record.arg);
+        }
+    }
+    if (_dropped)
+    {
+        PRINTLN("MatchLog: ", _dropped, " oldest records folded into the base state, replayed from there");
+    }
+
+    GameEngine engine(_trackLength);
+    GameSnapshot base = _base.getSnapshot();
+    uint32_t timeStart = micros();
+    for (uint32_t round = 0; round < REPLAY_ROUNDS; round++)
+    {
+        engine.restore(base);
+        for (uint16_t i = 0; i < _count; i++)
+        {
+            applyRecord(engine, _records[i]);
+        }
+    }
+    uint32_t elapsed = micros() - timeStart;
+
+    uint32_t events = (uint32_t)_count * REPLAY_ROUNDS;
+    bool isMatch = (engine.getWinner() == recordedWinner);
+    PRINTLN("MatchLog: replayed ", _count, " records x", REPLAY_ROUNDS, " in ", elapsed, "us, ",
+            elapsed ? (float)events * 1000000 / elapsed : 0.0f, " events/s");
+    PRINTLN("MatchLog: winner=", engine.getWinner(), ", recorded winner=", recordedWinner, isMatch ? " (match)" : " (MISMATCH)");
+    return isMatch;
+}
@@ -0,0 +1,103 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "../ArduProfFreeRTOS.h"
+#include "./GamePlayer.h"
+#include "./GameEngine.h"
+
+#define MATCH_LOG_SIZE 512 // records kept in RAM, the oldest are folded into the base state beyond
+
+typedef enum _MatchRecordType : uint8_t
+{
+    MatchRecordInput = 0, // arg=<GamePlayer>, an accepted click
+    MatchRecordStart, // arg=number of players
+    MatchRecordPause,
+    MatchRecordResume,
+    MatchRecordStop, // arg=<GamePlayer> winner, PlayerNull if stopped by button "Game"
+} MatchRecordType;
+
+typedef struct __attribute__((packed)) _MatchRecord
+{
+    uint32_t time; // us: ISR timestamp of an input, micros() of a state transition
+    uint8_t type;  // MatchRecordType
+    uint8_t arg;
+} MatchRecord;
+
+/////////////////////////////////////////////////////////////////////////////
+// binary log of a match: accepted inputs and state transitions in order of handling.
+// the engine is deterministic in the order of inputs, so replaying the log reproduces the match.
+// a record overwritten in a long match is first applied to a base engine: the log is then the state
+// of the match at its oldest kept record, plus the records from there on.
+// the log of the last match is saved to NVS when it ends and survives a reset
+/////////////////////////////////////////////////////////////////////////////
+class MatchLog
+{
+public:
+    MatchLog(uint16_t trackLength);
+
+    void begin(void); // clear the log for a new match
+    void append(MatchRecordType type, uint8_t arg, uint32_t time)
+    {
+        MatchRecord &record = _records[_head];
+        if (_count < MATCH_LOG_SIZE)
+        {
+            _count++;
+        }
+        else
+        {
+            applyRecord(_base, record); // the oldest record, appended by the game thread so valid
+            _dropped++;
+        }
+        record.time = time;
+        record.type = type;
+        record.arg = arg;
+        _head = (_head + 1) % MATCH_LOG_SIZE;
+    }
+
+    bool save(void); // write to NVS
+    bool load(void); // read the last saved match from NVS, if it was played on the same track
+
+    // re-run the loaded/recorded match through a GameEngine at full speed, check its winner and
+    // print the throughput in events per second. refused if a record is invalid
+    bool replay(void);
+
+private:
+    static bool isValid(const MatchRecord &record, uint8_t numPlayers);
+    static void applyRecord(GameEngine &engine, const MatchRecord &record)
+    {
+        if (record.type == MatchRecordInput)
+        {
+            engine.advance((GamePlayer)(record.arg));
+        }
+        else if (record.type == MatchRecordStart)
+        {
+            engine.reset(record.arg);
+        }
+    }
+
+    void linearize(void);
+
+    MatchRecord _records[MATCH_LOG_SIZE];
+    uint16_t _head;  // next record to write
+    uint16_t _count; // valid records, ending at _head
+    uint32_t _dropped; // records applied to _base
+    const uint16_t _trackLength;
+    GameEngine _base; // state of the match before the oldest kept record
+};
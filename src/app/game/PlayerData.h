@@ -19,10 +19,13 @@
  */
 #pragma once
 #include <Arduino.h>
+#include "./GamePlayer.h"
 
-typedef struct _PlayerData
+// state of all players in struct-of-arrays form, indexed by GamePlayer:
+// a pass over one field of every player walks one contiguous array
+typedef struct _PlayersData
 {
-    int countClick;
-    int countLoop;
-    uint16_t position;
-} PlayerData;
\ No newline at end of file
+    uint8_t countClick[GAME_NUM_PLAYERS];
+    uint16_t position[GAME_NUM_PLAYERS]; // position on the track, for rendering
+    uint32_t distance[GAME_NUM_PLAYERS]; // steps since start: loops * trackLength + position, never decreases
+} PlayersData;
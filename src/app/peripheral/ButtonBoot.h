@@ -36,7 +36,9 @@ class ButtonBoot : public DebounceButton
 public:
     ButtonBoot(QueueHandle_t queue) : DebounceButton(GPIO_BUTTON, BUTTON_STATE_ACTIVE, INPUT_PULLUP, queue)
     {
+#ifndef APP_BUTTON_POLLING
         enableInterrupt(CHANGE);
+#endif
     }
 
     ~ButtonBoot()
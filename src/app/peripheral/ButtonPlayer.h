@@ -21,30 +21,23 @@
 #include "./button/DebounceButton.h"
 #include "../pins.h"
 
-#ifdef GPIO_BUTTON
-#undef GPIO_BUTTON
-#endif
-
 /////////////////////////////////////////////////////////////
-// ButtonOnOff = ButtonBoot
+// button of a player, on one of the pins of PINS_SW_PLAYER
 /////////////////////////////////////////////////////////////
-#define GPIO_BUTTON PIN_SW_PLAYER1
 #define BUTTON_STATE_ACTIVE LOW
 
-class ButtonPlayer1 : public DebounceButton
+class ButtonPlayer : public DebounceButton
 {
 public:
-    ButtonPlayer1(QueueHandle_t queue) : DebounceButton(GPIO_BUTTON, BUTTON_STATE_ACTIVE, INPUT_PULLUP, queue)
+    ButtonPlayer(uint8_t pin, QueueHandle_t queue) : DebounceButton(pin, BUTTON_STATE_ACTIVE, INPUT_PULLUP, queue)
     {
+#ifndef APP_BUTTON_POLLING
         enableInterrupt(CHANGE);
+#endif
     }
 
-    ~ButtonPlayer1()
+    ~ButtonPlayer()
     {
         disableInterrupt();
     }
-
-    uint32_t edgeFallingTime;
 };
-
-#undef GPIO_BUTTON
@@ -0,0 +1,263 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <string.h>
+#include "./LedAnimation.h"
+
+#define GLIDE_MS 60       // a marker covers its remaining distance in about GLIDE_MS
+#define GLIDE_MIN_STEP 16 // Q8, minimum step of a gliding marker per frame
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// keyframes of the effects, level 0 to 255
+////////////////////////////////////////////////////////////////////////////////////////////
+static constexpr Keyframe KeyframesRun[] = {{0, 255}, {300, 80}, {600, 255}};
+static constexpr Keyframe KeyframesPause[] = {{0, 255}, {700, 24}, {1400, 255}};
+// even and odd leds flash in turn, the last frame equals the constant win pattern of RoundLed
+static constexpr Keyframe KeyframesWinEven[] = {{0, 0}, {200, 255}, {400, 48}, {600, 255}, {800, 48}, {1000, 255}};
+static constexpr Keyframe KeyframesWinOdd[] = {{0, 255}, {200, 0}, {400, 255}, {600, 0}, {800, 255}, {1000, 0}};
+
+#define EFFECT_OF(keyframes, isLoop) {keyframes, sizeof(keyframes) / sizeof(keyframes[0]), isLoop}
+static constexpr Effect EffectRun = EFFECT_OF(KeyframesRun, true);
+static constexpr Effect EffectPause = EFFECT_OF(KeyframesPause, true);
+static constexpr Effect EffectWinEven = EFFECT_OF(KeyframesWinEven, false);
+static constexpr Effect EffectWinOdd = EFFECT_OF(KeyframesWinOdd, false);
+
+static uint32_t effectDuration(const Effect &effect)
+{
+    return effect.keyframes[effect.count - 1].timeMs;
+}
+
+// level at timeMs, linearly interpolated between the keyframes around it
+static uint8_t effectLevel(const Effect &effect, uint32_t timeMs)
+{
+    const Keyframe *kf = effect.keyframes;
+    uint32_t duration = effectDuration(effect);
+    if (effect.isLoop && duration)
+    {
+        timeMs %= duration;
+    }
+    else if (timeMs >= duration)
+    {
+        return kf[effect.count - 1].level;
+    }
+
+    uint8_t k = 0;
+    while (k + 2 < effect.count && timeMs >= kf[k + 1].timeMs)
+    {
+        k++;
+    }
+    int32_t span = kf[k + 1].timeMs - kf[k].timeMs;
+    return (uint8_t)(kf[k].level + ((int32_t)kf[k + 1].level - kf[k].level) * (int32_t)(timeMs - kf[k].timeMs) / span);
+}
+
+// 0 to 255 -> 0 to FadeLevelMax
+static inline uint8_t toFadeLevel(uint32_t level)
+{
+    return (uint8_t)((level * FadeLevelMax + 128) >> 8);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+LedAnimation::LedAnimation(uint16_t numLeds) : _numLeds(numLeds),
+                                               _span((uint32_t)numLeds << 8)
+{
+    reset();
+}
+
+void LedAnimation::reset(uint8_t numPlayers)
+{
+    _numPlayers = (numPlayers >= 1 && numPlayers <= GAME_NUM_PLAYERS) ? numPlayers : GAME_NUM_PLAYERS;
+    memset(_position, 0, sizeof(_position));
+    memset(_target, 0, sizeof(_target));
+    _mode = AnimationNone;
+    _winner = 0;
+    _startMs = 0;
+    _lastMs = 0;
+    _isFirstFrame = true;
+    _isEffectDone = false;
+    _mixCount = 0;
+}
+
+void LedAnimation::setTarget(uint8_t player, uint16_t position)
+{
+    if (player < _numPlayers)
+    {
+        _target[player] = (uint32_t)(position % _numLeds) << 8;
+    }
+}
+
+void LedAnimation::play(AnimationMode mode, uint32_t nowMs, uint8_t winner)
+{
+    _mode = mode;
+    _winner = winner < _numPlayers ? winner : 0;
+    _startMs = nowMs;
+    _isEffectDone = false;
+}
+
+bool LedAnimation::isActive(void) const
+{
+    switch (_mode)
+    {
+    case AnimationRun:
+    case AnimationPause:
+        return true;
+    case AnimationWin:
+        return !_isEffectDone;
+    default:
+        break;
+    }
+    for (uint8_t p = 0; p < _numPlayers; p++)
+    {
+        if (_position[p] != _target[p])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LedAnimation::compose(uint8_t *track, uint32_t nowMs)
+{
+    uint32_t dtMs = _isFirstFrame ? 0 : nowMs - _lastMs;
+    _lastMs = nowMs;
+    _isFirstFrame = false;
+    glide(dtMs);
+
+    memset(track, 0, _numLeds);
+    _mixCount = 0;
+    uint32_t elapsedMs = nowMs - _startMs;
+    switch (_mode)
+    {
+    case AnimationWin:
+        drawWin(track, elapsedMs);
+        _isEffectDone = elapsedMs >= effectDuration(EffectWinEven);
+        break;
+    case AnimationRun:
+    {
+        // phases spread over one period, the smooth successor of blink time slots
+        uint32_t period = effectDuration(EffectRun);
+        for (uint8_t p = 0; p < _numPlayers; p++)
+        {
+            drawMarker(track, p, effectLevel(EffectRun, elapsedMs + period * p / _numPlayers));
+        }
+        break;
+    }
+    case AnimationPause:
+    {
+        uint8_t level = effectLevel(EffectPause, elapsedMs);
+        for (uint8_t p = 0; p < _numPlayers; p++)
+        {
+            drawMarker(track, p, level);
+        }
+        break;
+    }
+    default:
+        for (uint8_t p = 0; p < _numPlayers; p++)
+        {
+            drawMarker(track, p, 255);
+        }
+        break;
+    }
+    return isActive();
+}
+
+// markers only move forward: the distance to the target is taken around the track
+void LedAnimation::glide(uint32_t dtMs)
+{
+    if (dtMs == 0)
+    {
+        return;
+    }
+    if (dtMs > GLIDE_MS)
+    {
+        dtMs = GLIDE_MS;
+    }
+    for (uint8_t p = 0; p < _numPlayers; p++)
+    {
+        uint32_t distance = (_target[p] + _span - _position[p]) % _span;
+        if (distance == 0)
+        {
+            continue;
+        }
+        uint32_t step = distance * dtMs / GLIDE_MS;
+        step = step < GLIDE_MIN_STEP ? GLIDE_MIN_STEP : step;
+        step = step > distance ? distance : step;
+        _position[p] = (_position[p] + step) % _span;
+    }
+}
+
+// the led of the target lights at once, so a click shows in the next frame; the gliding marker
+// follows as a trail at half level, lighting the two leds it is between faded by its fraction
+void LedAnimation::drawMarker(uint8_t *track, uint8_t player, uint8_t level)
+{
+    uint16_t target = (uint16_t)(_target[player] >> 8);
+    uint16_t led = (uint16_t)(_position[player] >> 8);
+    uint32_t frac = _position[player] & 0xFF;
+    uint16_t next = (led + 1 < _numLeds) ? led + 1 : 0;
+    uint32_t trail = _position[player] != _target[player] ? level / 2 : 0;
+
+    drawLevel(track, target, player, toFadeLevel(level));
+    drawLevel(track, led, player, toFadeLevel(trail * (256 - frac) >> 8));
+    drawLevel(track, next, player, toFadeLevel(trail * frac >> 8));
+}
+
+// a led already lit by another player takes a mix slot holding both; once all slots are taken
+// the brighter player wins the led
+void LedAnimation::drawLevel(uint8_t *track, uint16_t led, uint8_t player, uint8_t level)
+{
+    uint8_t index = track[led];
+    uint8_t owner = index >> FadeLevelBits;
+    uint8_t current = index & FadeLevelMax;
+    if (level == 0)
+    {
+        return;
+    }
+    if (isMixIndex(index))
+    {
+        MixSlot &slot = _mix[owner - 1];
+        if (level > slot.level[player])
+        {
+            slot.level[player] = level;
+        }
+        return;
+    }
+    if (current && owner != player && _mixCount < MixSlots)
+    {
+        MixSlot &slot = _mix[_mixCount];
+        memset(slot.level, 0, sizeof(slot.level));
+        slot.position = led;
+        slot.level[owner] = current;
+        slot.level[player] = level;
+        track[led] = mixIndex(_mixCount++);
+        return;
+    }
+    if (level > current)
+    {
+        track[led] = fadeIndex(player, level);
+    }
+}
+
+void LedAnimation::drawWin(uint8_t *track, uint32_t elapsedMs)
+{
+    uint8_t even = fadeIndex(_winner, toFadeLevel(effectLevel(EffectWinEven, elapsedMs)));
+    uint8_t odd = fadeIndex(_winner, toFadeLevel(effectLevel(EffectWinOdd, elapsedMs)));
+    for (uint16_t i = 0; i < _numLeds; i++)
+    {
+        track[i] = (i % 2) == 0 ? even : odd;
+    }
+}
@@ -0,0 +1,137 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <stdint.h>
+#include "../game/GamePlayer.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// fixed-point animation of the track, composed in track order with one fade index per led:
+// player in the 3 high bits, level in the 5 low bits (level 0 is off), see RoundLed::uiShowFade()
+// a led lit by several players holds a mix index instead, its colour is the sum of their colours
+//
+// positions are Q8 (1/256 led): the led at the position of a player lights at once, its marker
+// glides there as a trail drawn on two neighbouring leds, faded by its fraction.
+// levels follow keyframed effects over time (ms)
+/////////////////////////////////////////////////////////////////////////////
+constexpr uint8_t FadeLevelBits = 5;
+constexpr uint8_t FadeLevelMax = (1 << FadeLevelBits) - 1;
+
+constexpr uint8_t fadeIndex(uint8_t player, uint8_t level)
+{
+    return (uint8_t)((player << FadeLevelBits) | level);
+}
+static_assert(GAME_NUM_PLAYERS <= (1 << (8 - FadeLevelBits)), "a fade index holds the player in its high bits");
+
+// fade indices of level 0 are off whatever their player: those of players 1 to MixSlots refer to a MixSlot
+constexpr uint8_t MixSlots = (1 << (8 - FadeLevelBits)) - 1;
+
+constexpr uint8_t mixIndex(uint8_t slot)
+{
+    return fadeIndex(slot + 1, 0);
+}
+constexpr bool isMixIndex(uint8_t index)
+{
+    return (index & FadeLevelMax) == 0 && index != 0;
+}
+
+// players on a led of the track, drawn additively
+typedef struct _MixSlot
+{
+    uint16_t position;                // led of the track
+    uint8_t level[GAME_NUM_PLAYERS];  // fade level of each player, 0 if it is not on the led
+} MixSlot;
+
+// level (0 to 255) at timeMs from the start of an effect
+typedef struct _Keyframe
+{
+    uint16_t timeMs;
+    uint8_t level;
+} Keyframe;
+
+typedef struct _Effect
+{
+    const Keyframe *keyframes; // sorted by time, the first one at 0 ms
+    uint8_t count;
+    bool isLoop; // repeated every keyframes[count - 1].timeMs, else held at its last level
+} Effect;
+
+typedef enum _AnimationMode : uint8_t
+{
+    AnimationNone = 0, // markers only glide, at full level
+    AnimationRun,      // markers pulse, each player in its own phase
+    AnimationPause,    // markers breathe together
+    AnimationWin,      // all leds in the colour of the winner, played once
+} AnimationMode;
+
+class LedAnimation
+{
+public:
+    // numLeds: length of the track
+    LedAnimation(uint16_t numLeds);
+
+    // markers of numPlayers (1 to GAME_NUM_PLAYERS) jump to position 0, no effect
+    void reset(uint8_t numPlayers = GAME_NUM_PLAYERS);
+    // the led at position lights in the next frame, the marker of player glides to it
+    void setTarget(uint8_t player, uint16_t position);
+    void play(AnimationMode mode, uint32_t nowMs, uint8_t winner = 0);
+
+    // track: numLeds fade indices, fully rewritten
+    // returns true while a further frame differs, i.e. a marker is gliding or an effect is running
+    bool compose(uint8_t *track, uint32_t nowMs);
+    bool isActive(void) const;
+
+    // mix slots referred to by the track of the last compose()
+    const MixSlot *getMixSlots(void) const
+    {
+        return _mix;
+    }
+    uint8_t getMixCount(void) const
+    {
+        return _mixCount;
+    }
+
+    uint16_t getNumLeds(void) const
+    {
+        return _numLeds;
+    }
+
+private:
+    void glide(uint32_t dtMs);
+    void drawMarker(uint8_t *track, uint8_t player, uint8_t level);
+    void drawLevel(uint8_t *track, uint16_t led, uint8_t player, uint8_t level);
+    void drawWin(uint8_t *track, uint32_t elapsedMs);
+
+    uint16_t _numLeds;
+    uint32_t _span; // numLeds in Q8
+    uint8_t _numPlayers; // markers drawn
+
+    uint32_t _position[GAME_NUM_PLAYERS]; // Q8
+    uint32_t _target[GAME_NUM_PLAYERS];   // Q8
+
+    AnimationMode _mode;
+    uint8_t _winner;
+    uint32_t _startMs;   // start of the effect
+    uint32_t _lastMs;    // time of the last composed frame
+    bool _isFirstFrame;  // no glide on the first frame after reset()
+    bool _isEffectDone;  // the last frame of a non-looping effect is composed
+
+    MixSlot _mix[MixSlots];
+    uint8_t _mixCount;
+};
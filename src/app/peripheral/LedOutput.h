@@ -0,0 +1,92 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <stdint.h>
+#include <FastLED.h>
+#include "./LedPattern.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// output stage of RoundLed, run by its transmit task: a frame of palette indices is expanded to colours through
+// the palette and a 256 entry gamma/brightness table, then scaled down to a current budget.
+// inline, so RoundLed compiles the loops for its constant number of leds; host/test/bench_led_output.cpp
+// benchmarks them for other track lengths
+/////////////////////////////////////////////////////////////////////////////
+namespace ledoutput
+{
+    // WS2812 current estimate: each channel draws up to MaPerChannel at level 255, each led MaIdle when off
+    constexpr uint32_t MaPerChannel = 20;
+    constexpr uint32_t MaIdle = 1;
+
+    // output level of a channel: gamma 2.0 then brightness, rounded
+    constexpr uint8_t correctLevel(uint8_t level, uint8_t brightness)
+    {
+        return (uint8_t)(((((uint32_t)level * level + 127) / 255) * brightness + 127) / 255);
+    }
+
+    // lut: 256 entries, channel level -> output level
+    inline void buildLut(uint8_t *lut, uint8_t brightness)
+    {
+        for (uint16_t level = 0; level < 256; level++)
+        {
+            lut[level] = correctLevel((uint8_t)level, brightness);
+        }
+    }
+
+    // returns the sum of the output levels of all channels
+    inline uint32_t expand(const uint8_t *index, const ledpattern::Palette &palette, const uint8_t *lut, CRGB *out, uint16_t numLeds)
+    {
+        uint32_t levelSum = 0;
+        for (uint16_t i = 0; i < numLeds; i++)
+        {
+            const ledpattern::Rgb &c = palette.color[index[i]];
+            out[i] = CRGB(lut[c.r], lut[c.g], lut[c.b]);
+            levelSum += out[i].r + out[i].g + out[i].b;
+        }
+        return levelSum;
+    }
+
+    // estimated current (mA) of numLeds leds whose channels sum up to levelSum
+    constexpr uint32_t currentMa(uint32_t levelSum, uint16_t numLeds)
+    {
+        return (levelSum * MaPerChannel + 254) / 255 + numLeds * MaIdle;
+    }
+
+    // scales out down if its current exceeds budgetMa (0: no limit), returns true if it was scaled
+    inline bool limitPower(CRGB *out, uint16_t numLeds, uint32_t levelSum, uint32_t budgetMa)
+    {
+        uint32_t activeMa = (levelSum * MaPerChannel + 254) / 255;
+        if (budgetMa == 0 || activeMa + numLeds * MaIdle <= budgetMa)
+        {
+            return false;
+        }
+
+        // one division per frame, then a multiply and shift per channel
+        uint32_t activeBudgetMa = budgetMa > numLeds * MaIdle ? budgetMa - numLeds * MaIdle : 0;
+        uint32_t scale = activeBudgetMa * 256 / activeMa; // < 256 as activeMa > activeBudgetMa
+        for (uint16_t i = 0; i < numLeds; i++)
+        {
+            CRGB &led = out[i];
+            led.r = (uint8_t)((led.r * scale) >> 8);
+            led.g = (uint8_t)((led.g * scale) >> 8);
+            led.b = (uint8_t)((led.b * scale) >> 8);
+        }
+        return true;
+    }
+} // namespace ledoutput
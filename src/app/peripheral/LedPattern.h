@@ -0,0 +1,121 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////////////////
+// compile-time led patterns
+// a pattern holds one byte per pixel, an index into a 256 entry Palette of {r, g, b}, the same
+// layout as CRGB; both live in flash as constexpr data. the colors of a palette are built with
+// toRgb() from 0xRRGGBB values (e.g. CRGB::Red), patterns never hold colors
+//
+// usage:
+//   static constexpr auto PatternGameOn = ledpattern::alternatingIndex<1, NUM_LEDS>;
+//   static constexpr auto PatternRamp = ledpattern::gradientIndex<1, 32, NUM_LEDS>; // palette entries 1 to 32
+/////////////////////////////////////////////////////////////////////////////
+namespace ledpattern
+{
+    typedef struct _Rgb
+    {
+        uint8_t r;
+        uint8_t g;
+        uint8_t b;
+    } Rgb;
+
+    constexpr Rgb toRgb(uint32_t color)
+    {
+        return Rgb{(uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)(color)};
+    }
+
+    template <size_t N>
+    struct IndexPattern
+    {
+        uint8_t index[N];
+    };
+
+    typedef struct _Palette
+    {
+        Rgb color[256];
+    } Palette;
+
+    // saturating per channel sum, as CRGB::operator+=
+    constexpr Rgb addRgb(Rgb a, Rgb b)
+    {
+        return Rgb{(uint8_t)(a.r + b.r > 255 ? 255 : a.r + b.r),
+                   (uint8_t)(a.g + b.g > 255 ? 255 : a.g + b.g),
+                   (uint8_t)(a.b + b.b > 255 ? 255 : a.b + b.b)};
+    }
+
+    namespace detail
+    {
+        template <uint8_t Index, size_t... I>
+        constexpr IndexPattern<sizeof...(I)> solidIndex(std::index_sequence<I...>)
+        {
+            return IndexPattern<sizeof...(I)>{{((void)I, Index)...}};
+        }
+
+        template <uint8_t Index, size_t... I>
+        constexpr IndexPattern<sizeof...(I)> alternatingIndex(std::index_sequence<I...>)
+        {
+            return IndexPattern<sizeof...(I)>{{(uint8_t)((I % 2) == 0 ? Index : 0)...}};
+        }
+
+        // index of pixel i of n on the line from `from` to `to`, rounded to the nearest
+        constexpr uint8_t lerpIndex(uint8_t from, uint8_t to, size_t i, size_t n)
+        {
+            if (n < 2)
+            {
+                return from;
+            }
+            int32_t span = (int32_t)to - from;
+            int32_t half = (int32_t)(n - 1) * (span < 0 ? -1 : 1); // half a step, the division rounds to the nearest
+            return (uint8_t)(from + (span * (int32_t)(2 * i) + half) / (int32_t)(2 * (n - 1)));
+        }
+
+        template <uint8_t From, uint8_t To, size_t... I>
+        constexpr IndexPattern<sizeof...(I)> gradientIndex(std::index_sequence<I...>)
+        {
+            return IndexPattern<sizeof...(I)>{{lerpIndex(From, To, I, sizeof...(I))...}};
+        }
+    } // namespace detail
+
+    // all N pixels set to Index
+    template <uint8_t Index, size_t N>
+    constexpr IndexPattern<N> solidIndex = detail::solidIndex<Index>(std::make_index_sequence<N>{});
+
+    // even pixels set to Index, odd pixels to index 0
+    template <uint8_t Index, size_t N>
+    constexpr IndexPattern<N> alternatingIndex = detail::alternatingIndex<Index>(std::make_index_sequence<N>{});
+
+    // pixel 0 set to From, pixel N-1 to To, the pixels between to the evenly spaced indices in between:
+    // a color ramp over palette entries From to To
+    template <uint8_t From, uint8_t To, size_t N>
+    constexpr IndexPattern<N> gradientIndex = detail::gradientIndex<From, To>(std::make_index_sequence<N>{});
+
+    static_assert(gradientIndex<1, 32, 16>.index[0] == 1 && gradientIndex<1, 32, 16>.index[15] == 32 &&
+                      gradientIndex<1, 32, 16>.index[8] == 18,
+                  "gradientIndex spans From to To");
+    static_assert(gradientIndex<32, 1, 16>.index[0] == 32 && gradientIndex<32, 1, 16>.index[15] == 1 &&
+                      gradientIndex<7, 9, 1>.index[0] == 7,
+                  "gradientIndex runs both ways");
+
+} // namespace ledpattern
@@ -0,0 +1,171 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <string.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include "PowerManager.h"
+#include "../AppConfig.h"
+
+#define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_POWER
+#include "../AppLogModule.h"
+
+#define MIN_FREQ_MHZ 40 // XTAL frequency of ESP32-C3
+
+static const char *const powerStateName[PowerStateMax] = {"active", "idle", "lightSleep"};
+
+PowerManager::PowerManager() : _numWakeupPins(0),
+                               _lockActive(nullptr),
+                               _mux(portMUX_INITIALIZER_UNLOCKED),
+                               _state(PowerActive),
+                               _timeEnter(0),
+                               _sleepCount(0)
+{
+    memset(_wakeupPins, 0, sizeof(_wakeupPins));
+    memset(_timeInState, 0, sizeof(_timeInState));
+}
+
+void PowerManager::init(void)
+{
+    _timeEnter = esp_timer_get_time();
+
+#if CONFIG_PM_ENABLE
+    // dynamic frequency scaling only: automatic light sleep (tickless idle) is not enabled because
+    // GPIO wakeup turns the edge interrupts of the buttons into level interrupts, see lightSleep()
+    esp_pm_config_t config = {
+        .max_freq_mhz = (int)getCpuFrequencyMhz(),
+        .min_freq_mhz = MIN_FREQ_MHZ,
+        .light_sleep_enable = false,
+    };
+    if (esp_pm_configure(&config) != ESP_OK ||
+        esp_pm_lock_create(ESP_PM_APB_FREQ_MAX, 0, "PowerActive", &_lockActive) != ESP_OK)
+    {
+        LOG_WARN("esp_pm is not available, frequency scaling disabled");
+        _lockActive = nullptr;
+    }
+    else
+    {
+        esp_pm_lock_acquire(_lockActive);
+    }
+#else
+    LOG_WARN("CONFIG_PM_ENABLE is not set, frequency scaling disabled");
+#endif
+}
+
+bool PowerManager::attachWakeupPin(uint8_t pin, uint8_t activeState)
+{
+    if (_numWakeupPins >= PowerWakeupPinListSize)
+    {
+        return false;
+    }
+    _wakeupPins[_numWakeupPins++] = WakeupPin{pin, activeState};
+    return true;
+}
+
+void PowerManager::setIdleAllowed(bool isAllowed)
+{
+    if (isAllowed == isIdleAllowed())
+    {
+        return;
+    }
+
+    // the lock is taken before leaving idle, so the frame following the state change is sent at full speed
+    if (_lockActive && !isAllowed)
+    {
+        esp_pm_lock_acquire(_lockActive);
+    }
+    enterState(isAllowed ? PowerIdle : PowerActive);
+    if (_lockActive && isAllowed)
+    {
+        esp_pm_lock_release(_lockActive);
+    }
+}
+
+void PowerManager::lightSleep(void)
+{
+    if (!isIdleAllowed())
+    {
+        return;
+    }
+
+    // wakeup and interrupt type share one setting per pin: the edge interrupts are masked while the
+    // pins are armed as level wakeup sources, and restored afterwards
+    for (uint8_t i = 0; i < _numWakeupPins; i++)
+    {
+        gpio_num_t pin = (gpio_num_t)(_wakeupPins[i].pin);
+        gpio_intr_disable(pin);
+        gpio_wakeup_enable(pin, (_wakeupPins[i].activeState == LOW) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    }
+    esp_sleep_enable_gpio_wakeup();
+
+    enterState(PowerLightSleep);
+    _sleepCount++;
+    esp_light_sleep_start(); // esp_timer and the tick count are compensated for the time asleep
+    enterState(PowerIdle);
+
+    for (uint8_t i = 0; i < _numWakeupPins; i++)
+    {
+        gpio_num_t pin = (gpio_num_t)(_wakeupPins[i].pin);
+        gpio_wakeup_disable(pin);
+        gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE);
+#ifndef APP_BUTTON_POLLING
+        gpio_intr_enable(pin);
+#endif
+    }
+}
+
+uint64_t PowerManager::getTimeInState(PowerState state)
+{
+    portENTER_CRITICAL(&_mux);
+    uint64_t time = _timeInState[state];
+    if (state == _state)
+    {
+        time += esp_timer_get_time() - _timeEnter;
+    }
+    portEXIT_CRITICAL(&_mux);
+    return time;
+}
+
+void PowerManager::print(void)
+{
+    uint64_t total = 0;
+    uint64_t time[PowerStateMax];
+    for (int i = 0; i < PowerStateMax; i++)
+    {
+        time[i] = getTimeInState((PowerState)i);
+        total += time[i];
+    }
+    for (int i = 0; i < PowerStateMax; i++)
+    {
+        PRINTLN("Power ", powerStateName[i], ": ", (uint32_t)(time[i] / 1000), "ms (",
+                total ? (float)time[i] * 100 / total : 0.0f, "%)");
+    }
+    PRINTLN("Power lightSleep count=", _sleepCount);
+}
+
+void PowerManager::enterState(PowerState state)
+{
+    portENTER_CRITICAL(&_mux);
+    int64_t now = esp_timer_get_time();
+    _timeInState[_state] += now - _timeEnter;
+    _timeEnter = now;
+    _state = state;
+    portEXIT_CRITICAL(&_mux);
+}
@@ -0,0 +1,85 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <esp_pm.h>
+#include "../ArduProfFreeRTOS.h"
+#include "../AppConfig.h"
+
+#define PowerWakeupPinListSize (1 + GAME_NUM_PLAYERS) // button "Game" and one per player
+
+typedef enum _PowerState : uint8_t
+{
+    PowerActive = 0, // game running or paused, CPU/APB at max. frequency
+    PowerIdle,       // game stopped and frame static, awake: frequency may be scaled down
+    PowerLightSleep, // game stopped, in light sleep until a button is pressed
+    PowerStateMax,
+} PowerState;
+
+/////////////////////////////////////////////////////////////////////////////
+// power states of the device
+// ThreadGame allows idle once the game is stopped and the frame is static, QueueMain puts the
+// chip into light sleep when it has nothing to do; any button wakes it up.
+// time spent in each state is accounted for battery life estimation
+/////////////////////////////////////////////////////////////////////////////
+class PowerManager
+{
+public:
+    PowerManager();
+
+    void init(void);
+    bool attachWakeupPin(uint8_t pin, uint8_t activeState);
+
+    // thread-safe, may be called from any task
+    void setIdleAllowed(bool isAllowed);
+    bool isIdleAllowed(void) const
+    {
+        return _state != PowerActive;
+    }
+
+    // blocks until a wakeup pin is active, call with the button interrupts quiet (no pending edges)
+    void lightSleep(void);
+
+    // us spent in state, including the current period
+    uint64_t getTimeInState(PowerState state);
+    uint32_t getSleepCount(void) const
+    {
+        return _sleepCount;
+    }
+    void print(void);
+
+private:
+    void enterState(PowerState state);
+
+    typedef struct _WakeupPin
+    {
+        uint8_t pin;
+        uint8_t activeState;
+    } WakeupPin;
+    WakeupPin _wakeupPins[PowerWakeupPinListSize];
+    uint8_t _numWakeupPins;
+
+    esp_pm_lock_handle_t _lockActive; // held in PowerActive, nullptr if power management is not available
+    portMUX_TYPE _mux;
+
+    volatile PowerState _state;
+    int64_t _timeEnter; // esp_timer_get_time() when _state was entered
+    uint64_t _timeInState[PowerStateMax];
+    uint32_t _sleepCount;
+};
@@ -0,0 +1,107 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////////////////
+// LED track layout: one or more rings / strips chained on PIN_WS2812_DIN, listed in wiring order.
+// the track runs through all segments in the order listed, a reversed segment is walked from its last pixel.
+//
+// examples:
+//   one 16 LED ring:            {{16, false}}
+//   one 60 LED strip:           {{60, false}}
+//   two chained 24 LED rings, the second one mounted upside down: {{24, false}, {24, true}}
+/////////////////////////////////////////////////////////////////////////////
+typedef struct _RingSegment
+{
+    uint16_t length;
+    bool isReversed;
+} RingSegment;
+
+static constexpr RingSegment RingLayout[] = {
+    {16, false},
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// derived at compile time, do not edit
+/////////////////////////////////////////////////////////////////////////////
+namespace ringconfig
+{
+    constexpr size_t NumSegment = sizeof(RingLayout) / sizeof(RingLayout[0]);
+
+    constexpr uint16_t totalLeds(void)
+    {
+        uint16_t total = 0;
+        for (size_t i = 0; i < NumSegment; i++)
+        {
+            total += RingLayout[i].length;
+        }
+        return total;
+    }
+
+    // track position -> pixel index on the data line
+    constexpr uint16_t pixelOf(uint16_t position)
+    {
+        uint16_t offset = 0;
+        for (size_t i = 0; i < NumSegment; i++)
+        {
+            const RingSegment &segment = RingLayout[i];
+            if (position < segment.length)
+            {
+                return offset + (segment.isReversed ? (segment.length - 1 - position) : position);
+            }
+            position -= segment.length;
+            offset += segment.length;
+        }
+        return offset; // out of range
+    }
+
+    constexpr bool isIdentity(void)
+    {
+        for (size_t i = 0; i < NumSegment; i++)
+        {
+            if (RingLayout[i].isReversed)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <size_t N>
+    struct PixelMap
+    {
+        uint16_t pixel[N];
+    };
+
+    template <size_t... I>
+    constexpr PixelMap<sizeof...(I)> makePixelMap(std::index_sequence<I...>)
+    {
+        return PixelMap<sizeof...(I)>{{pixelOf(I)...}};
+    }
+} // namespace ringconfig
+
+static constexpr uint16_t RingNumLeds = ringconfig::totalLeds();
+static constexpr bool RingIsIdentityMap = ringconfig::isIdentity();
+static constexpr auto RingPixelMap = ringconfig::makePixelMap(std::make_index_sequence<RingNumLeds>{});
+
+static_assert(RingNumLeds > 0, "RingLayout must have at least one led");
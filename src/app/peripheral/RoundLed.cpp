@@ -21,11 +21,24 @@
 #include <FastLED.h>
 
 #include "../AppDef.h"
+#include "../AppConfig.h"
+#include "../AppMessage.h"
 #include "../pins.h"
+#include "../game/GamePlayer.h"
 #include "./RoundLed.h"
+#include "./LedPattern.h"
+#include "./LedAnimation.h"
+#include "./LedOutput.h"
 
-// number of leds in a strip
-#define NUM_LEDS 16
+#define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_ROUND_LED
+#include "../AppLogModule.h"
+
+// number of leds on the data line, see RingConfig.h
+#define NUM_LEDS RingNumLeds
+
+#define TX_TASK_NAME "RoundLedTx"
+#define TX_TASK_STACK_SIZE LED_TX_STACK_SIZE // see AppConfig.h
+#define TX_TASK_PRIORITY 2 // below ThreadGame, transmission runs while the game thread waits for events
 
 // For led chips like WS2812, which have a data line, ground, and power, you just
 // need to define DATA_PIN.  For led chipsets that are SPI based (four wires - data, clock,
@@ -33,73 +46,153 @@
 // Clock pin only needed for SPI based chipsets when not using hardware SPI
 #define DATA_PIN PIN_WS2812_DIN
 
-// Define the array of leds
-static CRGB leds[NUM_LEDS];
-
-static const CRGB PatternAllClear[NUM_LEDS] = {0};
-static const CRGB PatternGameOn[NUM_LEDS] = {
-    CRGB::Red,
-    0,
-    CRGB::Red,
-    0,
-    CRGB::Red,
-    0,
-    CRGB::Red,
-    0,
-    CRGB::Red,
-    0,
-    CRGB::Red,
-    0,
-    CRGB::Red,
-    0,
-    CRGB::Red,
-    0,
-};
-static const CRGB PatternPlayer1Win[NUM_LEDS] = {
-    CRGB::Green,
-    0,
-    CRGB::Green,
-    0,
-    CRGB::Green,
-    0,
-    CRGB::Green,
-    0,
-    CRGB::Green,
-    0,
-    CRGB::Green,
-    0,
-    CRGB::Green,
-    0,
+// a frame is composed with one palette index per led, see PaletteFade / PaletteSystem
+// the pixels of the mix indices of an animated frame are black in PaletteFade, they are overwritten by their mix colour
+typedef struct _LedFrame
+{
+    uint8_t index[NUM_LEDS];
+    const ledpattern::Palette *palette;
+    uint8_t brightness;
+    uint8_t mixCount;
+    uint16_t mixPixel[MixSlots];
+    ledpattern::Rgb mixColor[MixSlots];
+} LedFrame;
+
+// back frame and front frame
+static LedFrame ledFrames[2];
+// front frame expanded through its palette and the gamma/brightness table, owned by the transmit task
+static CRGB ledOut[NUM_LEDS];
+
+static StackType_t xTxStack[TX_TASK_STACK_SIZE];
+static StaticTask_t xTxTaskBuffer;
+
+// colour of each player, index = GamePlayer
+static constexpr uint32_t PlayerPalette[] = {
     CRGB::Green,
-    0,
-};
-static const CRGB PatternPlayer2Win[NUM_LEDS] = {
-    CRGB::Blue,
-    0,
-    CRGB::Blue,
-    0,
-    CRGB::Blue,
-    0,
-    CRGB::Blue,
-    0,
-    CRGB::Blue,
-    0,
     CRGB::Blue,
-    0,
-    CRGB::Blue,
-    0,
-    CRGB::Blue,
-    0,
+    CRGB::Yellow,
+    CRGB::Magenta,
+    CRGB::Cyan,
+    CRGB::OrangeRed,
+    CRGB::Purple,
+    CRGB::White,
+};
+static_assert(sizeof(PlayerPalette) / sizeof(PlayerPalette[0]) >= GAME_NUM_PLAYERS, "a colour is required for each player");
+
+// index of an animated frame: see fadeIndex(), the colour of the player scaled by the level
+static constexpr ledpattern::Rgb fadePlayer(size_t index)
+{
+    size_t player = index >> FadeLevelBits;
+    uint32_t level = index & FadeLevelMax;
+    if (player >= GAME_NUM_PLAYERS)
+    {
+        return ledpattern::toRgb(0);
+    }
+    ledpattern::Rgb color = ledpattern::toRgb(PlayerPalette[player]);
+    return ledpattern::Rgb{(uint8_t)(color.r * level / FadeLevelMax),
+                           (uint8_t)(color.g * level / FadeLevelMax),
+                           (uint8_t)(color.b * level / FadeLevelMax)};
+}
+template <size_t... I>
+static constexpr ledpattern::Palette makeFadePalette(std::index_sequence<I...>)
+{
+    return ledpattern::Palette{{fadePlayer(I)...}};
+}
+static constexpr ledpattern::Palette PaletteFade = makeFadePalette(std::make_index_sequence<256>{});
+
+// colours of the constant patterns which are not drawn by players
+enum : uint8_t
+{
+    SystemIndexOff = 0,
+    SystemIndexGameOn,
 };
+template <size_t... I>
+static constexpr ledpattern::Palette makeSystemPalette(std::index_sequence<I...>)
+{
+    return ledpattern::Palette{{ledpattern::toRgb(I == SystemIndexGameOn ? CRGB::Red : 0)...}};
+}
+static constexpr ledpattern::Palette PaletteSystem = makeSystemPalette(std::make_index_sequence<256>{});
+
+// patterns are generated at compile time for NUM_LEDS and kept in flash, one byte per led
+static constexpr auto PatternAllClear = ledpattern::solidIndex<SystemIndexOff, NUM_LEDS>;
+static constexpr auto PatternGameOn = ledpattern::alternatingIndex<SystemIndexGameOn, NUM_LEDS>;
+
+// win pattern of each player: its colour at full level on alternating leds, the last frame of the win effect
+typedef struct _PlayerWinPatterns
+{
+    ledpattern::IndexPattern<NUM_LEDS> player[GAME_NUM_PLAYERS];
+} PlayerWinPatterns;
+
+template <size_t... P>
+static constexpr PlayerWinPatterns makePlayerWinPatterns(std::index_sequence<P...>)
+{
+    return PlayerWinPatterns{{ledpattern::alternatingIndex<fadeIndex(P, FadeLevelMax), NUM_LEDS>...}};
+}
+static constexpr PlayerWinPatterns PatternPlayerWin = makePlayerWinPatterns(std::make_index_sequence<GAME_NUM_PLAYERS>{});
+static_assert(sizeof(PatternGameOn) == sizeof(ledFrames[0].index), "pattern size must match frame size");
+
+// same mix colours on the same pixels
+static bool isMixEqual(const LedFrame &a, const LedFrame &b)
+{
+    if (a.mixCount != b.mixCount)
+    {
+        return false;
+    }
+    for (uint8_t k = 0; k < a.mixCount; k++)
+    {
+        if (a.mixPixel[k] != b.mixPixel[k] || memcmp(&a.mixColor[k], &b.mixColor[k], sizeof(a.mixColor[k])) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// track position -> pixel index, resolved at compile time for a plain (non-reversed) layout
+static inline uint16_t toPixel(uint16_t position)
+{
+    if constexpr (RingIsIdentityMap)
+    {
+        return position;
+    }
+    else
+    {
+        return RingPixelMap.pixel[position];
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////
+RoundLed::RoundLed(QueueHandle_t queue) : MessageQueue(queue),
+                                           _txTask(nullptr),
+                                           _back(0),
+                                           _isTxBusy(false),
+                                           _isCommitPending(false),
+                                           _framePattern{nullptr, nullptr},
+                                           _frameTimestamp{0, 0},
+                                           _isFrameShown(false),
+                                           _brightness(LED_BRIGHTNESS),
+                                           _lutBrightness(0),
+                                           _framesLimited(0),
+                                           _lastCurrentMa(0),
+                                           _peakCurrentMa(0),
+                                           _framesSent(0),
+                                           _framesSkipped(0)
+{
+}
+
 void RoundLed::init(void)
 {
-    memset(leds, 0, sizeof(leds));
+    memset(ledFrames, 0, sizeof(ledFrames));
+    ledFrames[0].palette = ledFrames[1].palette = &PaletteSystem;
+    memset(ledOut, 0, sizeof(ledOut));
+    _framePattern[0] = _framePattern[1] = nullptr;
+    _frameTimestamp[0] = _frameTimestamp[1] = 0;
+    _isFrameShown = false;
+    buildLut(_brightness);
 
     // Uncomment/edit one of the following lines for your leds arrangement.
     // ## Clockless types ##
-    FastLED.addLeds<NEOPIXEL, DATA_PIN>(leds, NUM_LEDS); // GRB ordering is assumed
+    FastLED.addLeds<NEOPIXEL, DATA_PIN>(ledOut, NUM_LEDS); // GRB ordering is assumed
     // FastLED.addLeds<SM16703, DATA_PIN, RGB>(leds, NUM_LEDS);
     // FastLED.addLeds<TM1829, DATA_PIN, RGB>(leds, NUM_LEDS);
     // FastLED.addLeds<TM1812, DATA_PIN, RGB>(leds, NUM_LEDS);
@@ -138,53 +231,187 @@ void RoundLed::init(void)
     // FastLED.addLeds<DOTSTAR, DATA_PIN, CLOCK_PIN, RGB>(leds, NUM_LEDS);  // BGR ordering is typical
     // FastLED.addLeds<APA102, DATA_PIN, CLOCK_PIN, RGB>(leds, NUM_LEDS);  // BGR ordering is typical
     // FastLED.addLeds<SK9822, DATA_PIN, CLOCK_PIN, RGB>(leds, NUM_LEDS);  // BGR ordering is typical
+
+    _txTask = xTaskCreateStaticPinnedToCore(
+        [](void *instance)
+        { static_cast<RoundLed *>(instance)->txLoop(); },
+        TX_TASK_NAME,
+        TX_TASK_STACK_SIZE,
+        this,
+        TX_TASK_PRIORITY,
+        xTxStack,
+        &xTxTaskBuffer,
+        ARDUINO_RUNNING_CORE);
 }
-uint16_t RoundLed::getTotalLeds(void)
+
+// 256 entry table of the output level of a channel, owned by the transmit task
+void RoundLed::buildLut(uint8_t brightness)
 {
-    return NUM_LEDS;
+    ledoutput::buildLut(_lut, brightness);
+    _lutBrightness = brightness;
 }
-void RoundLed::clearBuf(void)
+
+// scale ledOut down if its estimated current exceeds LED_POWER_BUDGET_MA
+// levelSum: sum of the levels of all channels of ledOut
+void RoundLed::limitPower(uint32_t levelSum)
 {
-    memset(leds, 0, sizeof(leds));
+    _lastCurrentMa = ledoutput::currentMa(levelSum, NUM_LEDS);
+    if (_lastCurrentMa > _peakCurrentMa)
+    {
+        _peakCurrentMa = _lastCurrentMa;
+    }
+    if (ledoutput::limitPower(ledOut, NUM_LEDS, levelSum, LED_POWER_BUDGET_MA))
+    {
+        _framesLimited++;
+    }
 }
-void RoundLed::setPlayer1LedBuf(uint16_t position, bool onoff)
+
+// transmit task: the only caller of FastLED.show()
+// the front frame is expanded to colours here, off the game thread
+void RoundLed::txLoop(void)
 {
-    if (onoff && position < NUM_LEDS)
+    for (;;)
     {
-        leds[position] += CRGB::Green;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        const LedFrame &frame = ledFrames[_back ^ 1];
+        uint32_t timestamp = _frameTimestamp[_back ^ 1];
+        if (frame.brightness != _lutBrightness)
+        {
+            buildLut(frame.brightness);
+        }
+        uint32_t levelSum = ledoutput::expand(frame.index, *frame.palette, _lut, ledOut, NUM_LEDS);
+        for (uint8_t k = 0; k < frame.mixCount; k++)
+        {
+            const ledpattern::Rgb &c = frame.mixColor[k];
+            CRGB &led = ledOut[frame.mixPixel[k]];
+            led = CRGB(_lut[c.r], _lut[c.g], _lut[c.b]);
+            levelSum += led.r + led.g + led.b;
+        }
+        limitPower(levelSum);
+        FastLED.show();
+        _isTxBusy = false;
+        sendMessageToTask(EVENT_ARGS(LedTxDone{timestamp}));
     }
 }
-void RoundLed::setPlayer2LedBuf(uint16_t position, bool onoff)
+// commit a frame composed by LedAnimation: fade indices in track order
+// the colour of a mix slot is the saturating sum of the colours of its players at their levels
+void RoundLed::uiShowFade(const uint8_t *track, const MixSlot *mixSlots, uint8_t mixCount)
 {
-    if (onoff && position < NUM_LEDS)
+    LedFrame &frame = ledFrames[_back];
+    if constexpr (RingIsIdentityMap)
     {
-        leds[position] += CRGB::Blue;
+        memcpy(frame.index, track, sizeof(frame.index));
     }
+    else
+    {
+        for (uint16_t position = 0; position < NUM_LEDS; position++)
+        {
+            frame.index[toPixel(position)] = track[position];
+        }
+    }
+    frame.mixCount = mixCount < MixSlots ? mixCount : MixSlots;
+    for (uint8_t k = 0; k < frame.mixCount; k++)
+    {
+        ledpattern::Rgb color = ledpattern::toRgb(0);
+        for (uint8_t p = 0; p < GAME_NUM_PLAYERS; p++)
+        {
+            color = ledpattern::addRgb(color, PaletteFade.color[fadeIndex(p, mixSlots[k].level[p])]);
+        }
+        frame.mixPixel[k] = toPixel(mixSlots[k].position);
+        frame.mixColor[k] = color;
+    }
+    frame.palette = &PaletteFade;
+    _framePattern[_back] = nullptr;
+    uiShow();
 }
 
+// takes effect on the next committed frame
+void RoundLed::setBrightness(uint8_t brightness)
+{
+    _brightness = brightness;
+}
+
+// commit the back buffer: skipped if it equals the front buffer, deferred if the front buffer is under transmission
 void RoundLed::uiShow(void)
 {
-    FastLED.show();
+    LedFrame &back = ledFrames[_back];
+    const LedFrame &front = ledFrames[_back ^ 1];
+    back.brightness = _brightness;
+    if (_isFrameShown && back.palette == front.palette && back.brightness == front.brightness &&
+        memcmp(back.index, front.index, sizeof(back.index)) == 0 && isMixEqual(back, front))
+    {
+        skipCommit();
+        return;
+    }
+
+    if (_isTxBusy)
+    {
+        _isCommitPending = true;
+        return;
+    }
+
+    // swap buffers: the new back buffer is fully recomposed before the next commit
+    _back ^= 1;
+    _frameTimestamp[_back] = 0;
+    _isCommitPending = false;
+    _isFrameShown = true;
+    _isTxBusy = true;
+    _framesSent++;
+    xTaskNotifyGive(_txTask);
 }
-void RoundLed::uiClear(void)
+
+// the back buffer equals the front buffer: a click drawn into it shows nothing new, its tag is dropped
+void RoundLed::skipCommit(void)
 {
-    // uiClear all leds
-    clearBuf();
-    uiShow();
+    _isCommitPending = false;
+    _frameTimestamp[_back] = 0;
+    _framesSkipped++;
 }
-void RoundLed::uiGamePlayer1Win(void)
+
+// show a constant pattern: nothing is copied nor committed if the front buffer already holds it
+void RoundLed::uiShowPattern(const void *pattern, const ledpattern::Palette *palette)
 {
-    memcpy(leds, PatternPlayer1Win, sizeof(leds));
+    if (_isFrameShown && _framePattern[_back ^ 1] == pattern && ledFrames[_back ^ 1].brightness == _brightness)
+    {
+        skipCommit();
+        return;
+    }
+
+    if (_framePattern[_back] != pattern)
+    {
+        memcpy(ledFrames[_back].index, pattern, sizeof(ledFrames[_back].index));
+        ledFrames[_back].palette = palette;
+        ledFrames[_back].mixCount = 0;
+        _framePattern[_back] = pattern;
+    }
     uiShow();
 }
-void RoundLed::uiGamePlayer2Win(void)
+
+UBaseType_t RoundLed::getTxStackHighWaterMark(void)
 {
-    memcpy(leds, PatternPlayer2Win, sizeof(leds));
-    uiShow();
+    return _txTask ? uxTaskGetStackHighWaterMark(_txTask) : 0;
+}
+
+void RoundLed::onTxDone(void)
+{
+    if (_isCommitPending)
+    {
+        uiShow();
+    }
+}
+void RoundLed::uiClear(void)
+{
+    uiShowPattern(&PatternAllClear, &PaletteSystem);
+}
+void RoundLed::uiGamePlayerWin(uint8_t player)
+{
+    if (player < GAME_NUM_PLAYERS)
+    {
+        uiShowPattern(&PatternPlayerWin.player[player], &PaletteFade);
+    }
 }
 
 void RoundLed::setGameLed(bool onoff)
 {
-    memcpy(leds, onoff ? PatternGameOn : PatternAllClear, sizeof(leds));
-    uiShow();
+    uiShowPattern(onoff ? (const void *)&PatternGameOn : (const void *)&PatternAllClear, &PaletteSystem);
 }
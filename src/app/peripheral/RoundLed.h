@@ -18,22 +18,113 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #pragma once
+#include <atomic>
+#include "../ArduProfFreeRTOS.h"
+#include "./RingConfig.h"
+#include "./LedPattern.h"
+#include "./LedAnimation.h"
 
-class RoundLed
+/////////////////////////////////////////////////////////////////////////////
+// frames are composed into a back buffer, uiShow() hands it to a transmit task as front buffer
+// the caller never blocks on LED I/O and never composes into a frame under transmission,
+// EventSystem/SysLedTxDone is sent to the queue once a frame is transmitted
+// a frame holds one palette index per led, the transmit task expands it to colours
+// through the palette and a 256 entry gamma/brightness table, then scales it down to LED_POWER_BUDGET_MA
+/////////////////////////////////////////////////////////////////////////////
+class RoundLed : public ardufreertos::MessageQueue
 {
 public:
+  RoundLed(QueueHandle_t queue);
+
   void init(void);
-  uint16_t getTotalLeds(void);
+  // length of the track in leds, a compile-time constant from RingConfig.h
+  static constexpr uint16_t getTotalLeds(void)
+  {
+    return RingNumLeds;
+  }
 
-  void clearBuf(void);
   void setGameLed(bool onoff);
-  void setPlayer1LedBuf(uint16_t position, bool onoff);
-  void setPlayer2LedBuf(uint16_t position, bool onoff);
+
+  // 0 (off) to 255 (full current), applied from the next committed frame
+  void setBrightness(uint8_t brightness);
+  uint8_t getBrightness(void) const
+  {
+    return _brightness;
+  }
+
+  // the back buffer draws a click with this ISR timestamp: it is carried by the frame and
+  // returned in the EventSystem/SysLedTxDone of its transmission. the earliest click is kept
+  void tagFrame(uint32_t timestamp)
+  {
+    if (timestamp && !_frameTimestamp[_back])
+    {
+      _frameTimestamp[_back] = timestamp;
+    }
+  }
 
   void uiShow(void);
+  // track: getTotalLeds() fade indices composed by LedAnimation, mixSlots: its mix slots
+  void uiShowFade(const uint8_t *track, const MixSlot *mixSlots = nullptr, uint8_t mixCount = 0);
   void uiClear(void);
-  void uiGamePlayer1Win(void);
-  void uiGamePlayer2Win(void);
+  void uiGamePlayerWin(uint8_t player);
+
+  // call on EventSystem/SysLedTxDone
+  void onTxDone(void);
+  // true if the last committed frame has been transmitted, i.e. the LEDs are static
+  bool isTxIdle(void) const
+  {
+    return !_isTxBusy && !_isCommitPending;
+  }
+
+  // number of frames transmitted / skipped because they equal the last transmitted frame
+  uint32_t getFramesSent(void) const
+  {
+    return _framesSent;
+  }
+  uint32_t getFramesSkipped(void) const
+  {
+    return _framesSkipped;
+  }
+
+  // number of frames scaled down to LED_POWER_BUDGET_MA, and estimated current (mA) of the last
+  // and the brightest transmitted frame before limiting
+  uint32_t getFramesLimited(void) const
+  {
+    return _framesLimited;
+  }
+  uint32_t getLastCurrentMa(void) const
+  {
+    return _lastCurrentMa;
+  }
+  uint32_t getPeakCurrentMa(void) const
+  {
+    return _peakCurrentMa;
+  }
+
+  // minimum free stack of the transmit task
+  UBaseType_t getTxStackHighWaterMark(void);
 
 private:
+  void txLoop(void);
+  void buildLut(uint8_t brightness);
+  void limitPower(uint32_t levelSum);
+  void uiShowPattern(const void *pattern, const ledpattern::Palette *palette);
+  void skipCommit(void);
+
+  TaskHandle_t _txTask;
+
+  uint8_t _back;                  // index of the back buffer, the other one is the front buffer
+  std::atomic<bool> _isTxBusy;    // front buffer is owned by the transmit task
+  bool _isCommitPending;          // back buffer is to be committed once the transmit task is idle
+  const void *_framePattern[2];   // constant pattern held by each buffer, nullptr if composed
+  uint32_t _frameTimestamp[2];    // see tagFrame(), read by the transmit task for the front buffer
+  bool _isFrameShown;             // false until the first frame is committed
+  uint8_t _brightness;            // brightness of the next committed frame
+  uint8_t _lutBrightness;         // brightness _lut is built for
+  uint8_t _lut[256];              // channel level -> output level, gamma 2.0 and brightness
+  uint32_t _framesLimited;        // written by the transmit task only
+  uint32_t _lastCurrentMa;
+  uint32_t _peakCurrentMa;
+  uint32_t _framesSent;
+  uint32_t _framesSkipped;
 };
@@ -0,0 +1,192 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <string.h>
+#include <driver/gpio.h>
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+#include "ButtonPoller.h"
+#include "DebounceButton.h"
+#include "../PowerManager.h"
+
+#define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_DEBOUNCE
+#include "../../AppLogModule.h"
+
+#define STABLE_MASK ((uint8_t)((1U << ButtonPollStableSamples) - 1))
+
+ButtonPoller *ButtonPoller::_instance = nullptr;
+
+bool ButtonPoller::attach(uint8_t pin, uint8_t activeState)
+{
+    if (_numButtons >= ButtonPollListSize)
+    {
+        return false;
+    }
+
+    PollState &state = _state[_numButtons++];
+    memset(&state, 0, sizeof(state));
+    state.pin = pin;
+    state.activeState = activeState;
+
+    // masked until the timer stops, see stopUntilEdge()
+    attachInterrupt(digitalPinToInterrupt(pin), wakeIsr, CHANGE);
+    gpio_intr_disable((gpio_num_t)pin);
+    return true;
+}
+
+void ButtonPoller::setWakeInterrupts(bool isEnabled)
+{
+    for (uint8_t i = 0; i < _numButtons; i++)
+    {
+        if (isEnabled)
+        {
+            gpio_intr_enable((gpio_num_t)_state[i].pin);
+        }
+        else
+        {
+            gpio_intr_disable((gpio_num_t)_state[i].pin);
+        }
+    }
+}
+
+// the first edge of any button while the timer is stopped: poll at the fast rate, the integrators pick the edge up
+void IRAM_ATTR ButtonPoller::wakeIsr(void)
+{
+    ButtonPoller *poller = _instance;
+    if (poller == nullptr || poller->_rate != PollRateOff)
+    {
+        return;
+    }
+    poller->setWakeInterrupts(false);
+    poller->_rate = PollRateFast;
+    poller->_idleSamples = 0;
+    BaseType_t isWoken = pdFALSE;
+    xTimerChangePeriodFromISR(poller->_timerStopped, ButtonPollFastInterval, &isWoken); // starts the timer
+    poller->_stat.calls++;
+    portYIELD_FROM_ISR(isWoken);
+}
+
+// runs in the timer service task
+void ButtonPoller::stopUntilEdge(TimerHandle_t xTimer)
+{
+    _timerStopped = xTimer;
+    _rate = PollRateOff;
+    xTimerStop(xTimer, 0);
+    setWakeInterrupts(true);
+
+    // an edge between the last sample and the interrupts being enabled raised nothing: sample it now
+    uint32_t levels = REG_READ(GPIO_IN_REG);
+    for (uint8_t i = 0; i < _numButtons; i++)
+    {
+        const PollState &state = _state[i];
+        if ((((levels >> state.pin) & 1) == state.activeState) != state.isRawActive)
+        {
+            setWakeInterrupts(false);
+            _rate = PollRateFast;
+            _idleSamples = 0;
+            xTimerChangePeriod(xTimer, ButtonPollFastInterval, 0);
+            return;
+        }
+    }
+}
+
+void ButtonPoller::pause(void)
+{
+    setWakeInterrupts(false);
+    stop();
+}
+
+void ButtonPoller::resume(void)
+{
+    _rate = PollRateFast;
+    _idleSamples = 0;
+    changePeriod(ButtonPollFastInterval); // starts the timer
+}
+
+// runs in the timer service task
+void ButtonPoller::isr(TimerHandle_t xTimer)
+{
+    uint32_t now = captureEdgeTime();
+    uint32_t levels = REG_READ(GPIO_IN_REG); // all GPIOs in one read
+
+    bool isSettled = true;
+    bool isNotify = false;
+    for (uint8_t i = 0; i < _numButtons; i++)
+    {
+        PollState &state = _state[i];
+        bool isRawActive = (((levels >> state.pin) & 1) == state.activeState);
+        if (isRawActive != state.isRawActive)
+        {
+            state.isRawActive = isRawActive;
+            state.timeChange = now;
+        }
+
+        state.history = (uint8_t)((state.history << 1) | (isRawActive ? 1 : 0)) & STABLE_MASK;
+        bool isStable = (state.history == 0) || (state.history == STABLE_MASK);
+        if (isStable && (state.history != 0) != state.isActive)
+        {
+            state.isActive = !state.isActive;
+            // the edge is stamped with the start of the stable run, not with the time it was accepted
+            uint8_t value = state.isActive ? state.activeState : !state.activeState;
+            isNotify |= DebounceButton::pushEdge(GpioEdge{state.timeChange, state.pin, value});
+            _stat.edges++;
+        }
+        isSettled &= isStable && !state.isActive;
+    }
+
+    // a notification lost to a full queue is sent again on the next sample
+    if (_isNotifyLost)
+    {
+        isNotify |= DebounceButton::claimEdgeNotify();
+    }
+    if (isNotify)
+    {
+        _isNotifyLost = !sendMessageToTask(EVENT_ARGS(GpioEdgeReady{}));
+        if (_isNotifyLost)
+        {
+            DebounceButton::abortEdgeNotify();
+            _stat.notifyLost++;
+        }
+    }
+
+    // adaptive scan rate
+    isSettled &= !_isNotifyLost;
+    _idleSamples = isSettled ? _idleSamples + 1 : 0;
+    if (_rate != PollRateFast && !isSettled)
+    {
+        _rate = PollRateFast;
+        xTimerChangePeriod(xTimer, ButtonPollFastInterval, 0);
+    }
+    else if (_idleSamples >= ButtonPollIdleSamples)
+    {
+        _idleSamples = 0;
+        if (_rate == PollRateFast)
+        {
+            _rate = PollRateSlow;
+            xTimerChangePeriod(xTimer, ButtonPollSlowInterval, 0);
+        }
+        else if (_powerManager && _powerManager->isIdleAllowed())
+        {
+            stopUntilEdge(xTimer);
+        }
+    }
+
+    _stat.calls++;
+    _stat.busyUs += captureEdgeTime() - now;
+}
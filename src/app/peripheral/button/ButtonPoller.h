@@ -0,0 +1,132 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "../../ArduProfFreeRTOS.h"
+#include "../../AppConfig.h"
+#include "../../AppMessage.h"
+#include "../../util/InputStat.h"
+#include "./DebounceDef.h"
+#include "./GpioEdge.h"
+
+class PowerManager;
+
+#define ButtonPollListSize (1 + GAME_NUM_PLAYERS) // button "Game" and one per player
+
+typedef struct _PollState
+{
+    uint8_t pin;
+    uint8_t activeState;
+    uint8_t history;     // one bit per sample, 1: active level
+    bool isActive;       // debounced level
+    bool isRawActive;    // level of the last sample
+    uint32_t timeChange; // captureEdgeTime() of the last raw level change
+} PollState;
+
+typedef enum _PollRate : uint8_t
+{
+    PollRateFast = 0, // ButtonPollFastInterval
+    PollRateSlow,     // ButtonPollSlowInterval
+    PollRateOff,      // timer stopped, the first edge of any button restarts it at the fast rate
+} PollRate;
+
+/////////////////////////////////////////////////////////////////////////////
+// interrupt-free button input (APP_BUTTON_POLLING)
+// all button GPIOs are sampled by one register read on each tick of a software timer and debounced by
+// a shift-register integrator per button: the level is accepted after ButtonPollStableSamples equal samples.
+// accepted edges go to DebounceButton's edge ring, so DebounceEngine handles them the same as ISR edges.
+// the timer runs at ButtonPollFastInterval while any button is pressed or settling, at ButtonPollSlowInterval when idle.
+// once the device is idle as well (game stopped, see PowerManager) and no gesture can be pending, the timer stops
+// and an edge interrupt of any button starts it again: a stopped game costs no CPU time for input
+/////////////////////////////////////////////////////////////////////////////
+class ButtonPoller : public ardufreertos::SoftwareTimer,
+                     ardufreertos::MessageQueue
+{
+public:
+    ButtonPoller(QueueHandle_t queue) : SoftwareTimer(
+                                            "Button Poller",
+                                            ButtonPollSlowInterval,
+                                            pdTRUE, // The timers will auto-reload themselves when they expire.
+                                            nullptr,
+                                            [](TimerHandle_t xTimer)
+                                            {
+                                                if (_instance != nullptr)
+                                                {
+                                                    _instance->isr(xTimer);
+                                                }
+                                            }),
+                                        MessageQueue(queue),
+                                        _numButtons(0),
+                                        _powerManager(nullptr),
+                                        _timerStopped(nullptr),
+                                        _idleSamples(0),
+                                        _rate(PollRateSlow),
+                                        _isNotifyLost(false),
+                                        _stat{0}
+    {
+        _instance = this;
+        memset(_state, 0, sizeof(_state));
+    }
+
+    bool attach(uint8_t pin, uint8_t activeState);
+    // the timer stops while powerManager allows idle, nullptr: it never stops
+    void attachPowerManager(PowerManager *powerManager)
+    {
+        _powerManager = powerManager;
+    }
+
+    // stop polling, e.g. during light sleep / start again at the fast rate
+    void pause(void);
+    void resume(void);
+    PollRate getRate(void) const
+    {
+        return _rate;
+    }
+
+    static const ButtonPoller *getInstance(void)
+    {
+        return _instance;
+    }
+
+    const InputStat &getStat(void) const
+    {
+        return _stat;
+    }
+
+protected:
+    virtual void isr(TimerHandle_t xTimer);
+
+private:
+    static ButtonPoller *_instance;
+    static void IRAM_ATTR wakeIsr(void);
+
+    void setWakeInterrupts(bool isEnabled);
+    void stopUntilEdge(TimerHandle_t xTimer);
+
+    PollState _state[ButtonPollListSize];
+    uint8_t _numButtons;
+
+    PowerManager *_powerManager;
+    TimerHandle_t _timerStopped; // the timer, as stopped by stopUntilEdge()
+    uint32_t _idleSamples; // consecutive samples at the current rate with every button released and settled
+    volatile PollRate _rate; // written by wakeIsr() while the timer is stopped, by isr() otherwise
+    bool _isNotifyLost; // the last EventGpioISR was not queued, retried on the next sample
+
+    InputStat _stat;
+};
@@ -18,13 +18,14 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #pragma once
+#include <atomic>
 #include <FunctionalInterrupt.h>
 #include "../../ArduProfFreeRTOS.h"
-#include "../../AppEvent.h"
+#include "../../AppConfig.h"
+#include "../../AppMessage.h"
+#include "../../util/InputStat.h"
 #include "./DebounceDef.h"
-#include "./DebounceTimer.h"
-
-class DebounceTimer;
+#include "./GpioEdge.h"
 
 class DebounceButton : public ardufreertos::MessageQueue
 {
@@ -35,18 +36,8 @@ public:
                    QueueHandle_t queue) : _PIN(pin),
                                           pinStateActive(activeState),
                                           isIntrEnable(false),
-                                          _debounceTimer(nullptr),
-                                          _eventValue(EventNull),
-                                          _buttonClick(EventNull),
-                                          _buttonDoubleClick(EventNull),
-                                          _buttonLongPress(EventNull),
                                           MessageQueue(queue)
     {
-        debounceCount = 0;
-        debounceActive = false;
-
-        _clickCount = 0;
-
         pinMode(_PIN, ioMode);
     }
 
@@ -55,15 +46,6 @@ public:
         disableInterrupt();
     }
 
-    bool init(int16_t evValue, int16_t clickValue, int16_t doubleClickValue, int16_t longPressValue)
-    {
-        _eventValue = evValue;
-        _buttonClick = clickValue;
-        _buttonDoubleClick = doubleClickValue;
-        _buttonLongPress = longPressValue;
-        return true;
-    }
-
     void enableInterrupt(uint8_t intrMode)
     {
         if (!isIntrEnable)
@@ -82,119 +64,78 @@ public:
         }
     }
 
-    void setDebounceActive(bool active)
+    uint8_t getPin(void)
     {
-        debounceCount = 0;
-        debounceActive = active;
+        return _PIN;
     }
-
-    bool isDebounceActive(void)
+    uint8_t getActiveState(void)
     {
-        return debounceActive;
+        return pinStateActive;
     }
-
-    void onEventIsr(uint8_t value, uint32_t ms)
+    int read(void)
     {
-        if (value == getActiveState())
-        {
-            _timeBegin = ms;
-            if (_clickCount == 0)
-            {
-                setDebounceActive(true);
-                if (_debounceTimer)
-                {
-                    _debounceTimer->start();
-                }
-            }
-        }
-        else if (isDebounceActive())
-        {
-            _timeEnd = ms;
-            uint32_t delta = (_timeEnd > _timeBegin) ? (_timeEnd - _timeBegin) : (_timeBegin - _timeEnd);
-            if (delta > DebounceDuration)
-            {
-                _clickCount++;
-            }
-        }
+        return digitalRead(_PIN);
     }
 
-    void onEventTimer(void)
+    /////////////////////////////////////////////////////////////////////////////
+    // edges of all buttons are queued in one lock-free ring by isr(),
+    // a single EventGpioISR is sent to wake the consumer until it starts draining
+    /////////////////////////////////////////////////////////////////////////////
+    static void beginDrainEdges(void)
     {
-        if (!isDebounceActive())
-        {
-            return;
-        }
-
-        if (digitalRead(_PIN) == pinStateActive)
-        {
-            if (debounceCount >= LongPressDuration)
-            {
-                _clickCount = 0;
-                setDebounceActive(false);
-                sendMessageToTask(_eventValue, _buttonLongPress, _PIN);
-            }
-            else
-            {
-                debounceCount += DebounceTimerInterval;
-            }
-        }
-        else if (debounceCount >= DoubleClickDuration)
-        {
-            int16_t event;
-            if (_clickCount == 1)
-            {
-                sendMessageToTask(_eventValue, _buttonClick, _PIN);
-            }
-            else if (_clickCount == 2)
-            {
-                sendMessageToTask(_eventValue, _buttonDoubleClick, _PIN);
-            }
-
-            _clickCount = 0;
-            setDebounceActive(false);
-        }
-        else
-        {
-            debounceCount += DebounceTimerInterval;
-            // setDebounceActive(false);
-        }
+        _isEdgeNotifyPending.store(false, std::memory_order_release);
     }
-
-    uint8_t getPin(void)
+    static bool popEdge(GpioEdge &edge)
     {
-        return _PIN;
+        return _edgeRing.pop(edge);
     }
-    uint8_t getActiveState(void)
+    static uint32_t getEdgeOverflow(void)
     {
-        return pinStateActive;
+        return _edgeRing.overflow();
     }
-    int read(void)
+    // returns true if the consumer has to be woken up by an EventGpioISR
+    static bool pushEdge(const GpioEdge &edge)
     {
-        return digitalRead(_PIN);
+        return _edgeRing.push(edge) && claimEdgeNotify();
+    }
+    // returns true if the caller is to send the EventGpioISR, i.e. none is pending
+    static bool claimEdgeNotify(void)
+    {
+        return !_isEdgeNotifyPending.exchange(true, std::memory_order_acq_rel);
+    }
+    // the EventGpioISR claimed could not be queued: the edges wait in the ring, the next producer
+    // call claims the notification again. without this input would stop for good once the queue was full
+    static void abortEdgeNotify(void)
+    {
+        _isEdgeNotifyPending.store(false, std::memory_order_release);
+    }
+    static const InputStat &getIsrStat(void)
+    {
+        return _isrStat;
     }
 
 protected:
-    uint32_t debounceCount;
-    bool debounceActive;
     uint8_t pinStateActive;
     bool isIntrEnable;
 
 private:
     void isr(void)
     {
-        sendMessageFromIsrToTask(EventGpioISR, _PIN, digitalRead(_PIN), millis());
-    }
-
-    int16_t _eventValue;
-    int16_t _buttonClick;
-    int16_t _buttonDoubleClick;
-    int16_t _buttonLongPress;
+        GpioEdge edge = {captureEdgeTime(), _PIN, (uint8_t)digitalRead(_PIN)};
+        if (pushEdge(edge) && !sendMessageFromIsrToTask(EVENT_ARGS(GpioEdgeReady{})))
+        {
+            abortEdgeNotify(); // the next edge sends it
+            _isrStat.notifyLost++;
+        }
 
-    friend DebounceTimer;
-    DebounceTimer *_debounceTimer;
+        _isrStat.calls++;
+        _isrStat.edges++;
+        _isrStat.busyUs += captureEdgeTime() - edge.time;
+    }
 
-    uint16_t _clickCount;
-    uint32_t _timeBegin, _timeEnd;
+    static GpioEdgeRing _edgeRing;
+    static std::atomic<bool> _isEdgeNotifyPending;
+    static InputStat _isrStat;
 
     const uint8_t _PIN;
     QueueHandle_t _queue;
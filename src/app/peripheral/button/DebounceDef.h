@@ -21,6 +21,10 @@
 
 // Button debounce time
 #define DebounceDuration pdMS_TO_TICKS(20) // 20ms
+#define DebounceDurationUs (20 * 1000UL)   // 20ms in unit of us, for ISR timestamps
+
+// Minimum press time of a DebouncePolicyClick button
+#define ClickMinPressUs (1 * 1000UL) // 1ms in unit of us
 
 // Button double click time
 #define DoubleClickDuration pdMS_TO_TICKS(500) // 500ms
@@ -30,3 +34,11 @@
 
 // Interval of debounce timer interrupt
 #define DebounceTimerInterval pdMS_TO_TICKS(5)
+
+// Button polling (APP_BUTTON_POLLING)
+#define ButtonPollFastInterval pdMS_TO_TICKS(1)  // while any button is pressed or settling
+#define ButtonPollSlowInterval pdMS_TO_TICKS(10) // while all buttons are released
+#define ButtonPollStableSamples 5                // equal samples to accept a level, 5ms at the fast rate
+#define ButtonPollIdleSamples 100                // idle samples at the fast rate before slowing down, then at
+                                                 // the slow rate before stopping if the device is idle
+static_assert(ButtonPollIdleSamples * ButtonPollSlowInterval > DoubleClickDuration, "polling stops once no gesture is pending");
@@ -0,0 +1,169 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <string.h>
+#include "DebounceEngine.h"
+
+#define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_DEBOUNCE
+#include "../../AppLogModule.h"
+
+DebounceEngine *DebounceEngine::_instance = nullptr;
+
+bool DebounceEngine::attach(ButtonId id, uint8_t pin, uint8_t activeState, DebouncePolicy policy)
+{
+    if (_numButtons >= DebounceButtonListSize)
+    {
+        return false;
+    }
+
+    DebounceState &state = _state[_numButtons++];
+    memset(&state, 0, sizeof(state));
+    state.pin = pin;
+    state.activeState = activeState;
+    state.policy = policy;
+    state.id = id;
+    return true;
+}
+
+bool DebounceEngine::onEdge(const GpioEdge &edge)
+{
+    for (uint8_t i = 0; i < _numButtons; i++)
+    {
+        DebounceState &state = _state[i];
+        if (state.pin == edge.pin)
+        {
+            bool isActive = (edge.value == state.activeState);
+            if (state.policy == DebouncePolicyClick)
+            {
+                onEdgeClick(state, isActive, edge.time);
+            }
+            else
+            {
+                onEdgeGesture(state, isActive, edge.time);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void DebounceEngine::onEventTimer(void)
+{
+    bool isGestureActive = false;
+    for (uint8_t i = 0; i < _numButtons; i++)
+    {
+        DebounceState &state = _state[i];
+        if (state.isGestureActive)
+        {
+            isGestureActive |= onTimerGesture(state);
+        }
+    }
+
+    // stop/disable debounce timer if all gestures are resolved
+    if (!isGestureActive)
+    {
+        stop();
+    }
+}
+
+bool DebounceEngine::isIdle(void) const
+{
+    for (uint8_t i = 0; i < _numButtons; i++)
+    {
+        if (_state[i].isPressed || _state[i].isGestureActive)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void DebounceEngine::onEdgeClick(DebounceState &state, bool isActive, uint32_t time)
+{
+    if (isActive)
+    {
+        state.timeBegin = time;
+        state.isPressed = true;
+    }
+    else if (state.isPressed)
+    {
+        state.isPressed = false;
+        uint32_t delta = time - state.timeBegin; // wrap-around safe
+        if (delta > ClickMinPressUs)
+        {
+            _listener->onButtonGesture(state.id, UserClick, time);
+        }
+    }
+}
+
+void DebounceEngine::onEdgeGesture(DebounceState &state, bool isActive, uint32_t time)
+{
+    if (isActive)
+    {
+        state.timeBegin = time;
+        state.isPressed = true;
+        if (state.clickCount == 0 && !state.isGestureActive)
+        {
+            state.isGestureActive = true;
+            state.debounceCount = 0;
+            start();
+        }
+    }
+    else
+    {
+        state.isPressed = false;
+        if (state.isGestureActive)
+        {
+            uint32_t delta = time - state.timeBegin; // wrap-around safe
+            if (delta > DebounceDurationUs)
+            {
+                state.clickCount++;
+            }
+        }
+    }
+}
+
+bool DebounceEngine::onTimerGesture(DebounceState &state)
+{
+    UserTriggerSource gesture;
+    bool isActive = (digitalRead(state.pin) == state.activeState);
+    if (isActive && state.debounceCount >= LongPressDuration)
+    {
+        gesture = UserLongPress;
+    }
+    else if (!isActive && state.debounceCount >= DoubleClickDuration)
+    {
+        // more than two clicks or bounce only: the gesture is dropped
+        gesture = (state.clickCount == 1) ? UserClick : ((state.clickCount == 2) ? UserDoubleClick : UserNull);
+    }
+    else
+    {
+        state.debounceCount += DebounceTimerInterval;
+        return true;
+    }
+
+    state.clickCount = 0;
+    state.isGestureActive = false;
+    if (gesture != UserNull)
+    {
+        _listener->onButtonGesture(state.id, gesture, 0);
+    }
+    return false;
+}
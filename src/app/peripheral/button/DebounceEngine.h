@@ -0,0 +1,119 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "../../ArduProfFreeRTOS.h"
+#include "../../AppConfig.h"
+#include "../../AppMessage.h"
+#include "./DebounceDef.h"
+#include "./GpioEdge.h"
+
+#define DebounceButtonListSize (1 + GAME_NUM_PLAYERS) // button "Game" and one per player
+
+/////////////////////////////////////////////////////////////////////////////
+// per-button debounce policy
+/////////////////////////////////////////////////////////////////////////////
+typedef enum _DebouncePolicy : uint8_t
+{
+    DebouncePolicyClick = 0, // click on release edge, resolved without the timer (player buttons)
+    DebouncePolicyGesture,   // click / double click / long press, resolved by the timer (game button)
+} DebouncePolicy;
+
+typedef struct _DebounceState
+{
+    uint8_t pin;
+    uint8_t activeState;
+    DebouncePolicy policy;
+    ButtonId id;
+
+    bool isPressed;         // last edge seen was the active level
+    bool isGestureActive;   // DebouncePolicyGesture only: serviced by the timer
+    uint8_t clickCount;     // DebouncePolicyGesture only
+    uint32_t timeBegin;     // micros() of the last press edge
+    uint32_t debounceCount; // DebouncePolicyGesture only: ticks since the gesture began
+} DebounceState;
+
+class DebounceListener
+{
+public:
+    // timestamp: micros() of the GPIO ISR which completed the gesture, 0 if resolved by the timer
+    virtual void onButtonGesture(ButtonId id, UserTriggerSource gesture, uint32_t timestamp) = 0;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// table-driven debounce of N buttons
+// state of all buttons lives in one contiguous array; edges are looked up by pin and the
+// timer tick walks the array once, so a new button is one more row, not a new code path or timer
+/////////////////////////////////////////////////////////////////////////////
+class DebounceEngine : public ardufreertos::SoftwareTimer,
+                       ardufreertos::MessageQueue
+{
+public:
+    DebounceEngine(QueueHandle_t queue,
+                   TimerId timerId,
+                   DebounceListener *listener) : SoftwareTimer(
+                                                     "Debounce Timer",
+                                                     DebounceTimerInterval,
+                                                     pdTRUE, // The timers will auto-reload themselves when they expire.
+                                                     nullptr,
+                                                     [](TimerHandle_t xTimer)
+                                                     {
+                                                         if (_instance != nullptr)
+                                                         {
+                                                             _instance->isr(xTimer);
+                                                         }
+                                                     }),
+                                                 MessageQueue(queue),
+                                                 _numButtons(0),
+                                                 _timerId(timerId),
+                                                 _listener(listener)
+    {
+        _instance = this;
+        memset(_state, 0, sizeof(_state));
+    }
+
+    bool attach(ButtonId id, uint8_t pin, uint8_t activeState, DebouncePolicy policy);
+
+    // return false if pin is not attached
+    bool onEdge(const GpioEdge &edge);
+    void onEventTimer(void);
+
+    // true if every button is released and no gesture is in progress
+    bool isIdle(void) const;
+
+protected:
+    virtual void isr(TimerHandle_t)
+    {
+        sendMessageFromIsrToTask(EVENT_ARGS(TimerTick{_timerId}));
+    }
+
+private:
+    static DebounceEngine *_instance;
+
+    void onEdgeClick(DebounceState &state, bool isActive, uint32_t time);
+    void onEdgeGesture(DebounceState &state, bool isActive, uint32_t time);
+    // return true while the gesture is still in progress
+    bool onTimerGesture(DebounceState &state);
+
+    DebounceState _state[DebounceButtonListSize];
+    uint8_t _numButtons;
+
+    TimerId _timerId;
+    DebounceListener *_listener;
+};
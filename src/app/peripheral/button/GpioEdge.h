@@ -0,0 +1,67 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <stdint.h>
+#include <esp_timer.h>
+#include "../../util/SpscRing.h"
+
+// a GPIO edge captured in DebounceButton::isr()
+typedef struct _GpioEdge
+{
+    uint32_t time; // captureEdgeTime(), in unit of us
+    uint8_t pin;
+    uint8_t value;
+} GpioEdge;
+
+// edge timestamp in us, taken first thing in the ISR
+// esp_timer is the time base of micros(), so timestamps compare directly with micros() in tasks
+static inline uint32_t captureEdgeTime(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+// edges are ordered by capture time (wrap-around safe), edges captured in the same us by pin number,
+// so the order of simultaneous presses does not depend on the order they were queued in
+static inline bool isEdgeBefore(const GpioEdge &a, const GpioEdge &b)
+{
+    int32_t delta = (int32_t)(a.time - b.time);
+    return (delta < 0) || (delta == 0 && a.pin < b.pin);
+}
+
+// insertion sort: a drained batch is almost in order already, so this is close to a single pass
+static inline void sortEdges(GpioEdge *edges, uint32_t count)
+{
+    for (uint32_t i = 1; i < count; i++)
+    {
+        GpioEdge edge = edges[i];
+        uint32_t j = i;
+        while (j > 0 && isEdgeBefore(edge, edges[j - 1]))
+        {
+            edges[j] = edges[j - 1];
+            j--;
+        }
+        edges[j] = edge;
+    }
+}
+
+#define GPIO_EDGE_RING_SIZE 64 // must be a power of 2
+
+// all button ISRs are dispatched by the single GPIO interrupt handler on ESP32-C3, so there is one producer
+typedef SpscRing<GpioEdge, GPIO_EDGE_RING_SIZE> GpioEdgeRing;
@@ -27,4 +27,11 @@
 #define PIN_SW_PLAYER2 GPIO_NUM_7 // Player2 button (pull-up)
 #define PIN_BOOT GPIO_NUM_9       // Boot button
 #define PIN_SW_GAME GPIO_NUM_9    // Game button (pull-up)
+
+// button of each player in order of GamePlayer, at least GAME_NUM_PLAYERS pins (see AppConfig.h)
+// free GPIOs of XIAO ESP32C3 for more players: GPIO_NUM_3, GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_10
+// may be given by the build instead, e.g. -DPINS_SW_PLAYER={6,7,3,4,5,10}
+#ifndef PINS_SW_PLAYER
+#define PINS_SW_PLAYER {PIN_SW_PLAYER1, PIN_SW_PLAYER2}
+#endif
 #endif
@@ -21,15 +21,22 @@
 #include "../util/EspUtil.h"
 #include "../AppContext.h"
 #include "../AppDef.h"
+#include "../AppConfig.h"
+#include "../AppMessage.h"
+#include "../util/LatencyStat.h"
+#include "../util/Trace.h"
+#include "../peripheral/PowerManager.h"
 
-////////////////////////////////////////////////////////////////////////////////////////////
-#define MIN_DEBOUNCE_TIME pdMS_TO_TICKS(1)
+#define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_QUEUE_MAIN
+#include "../AppLogModule.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 // Thread for core1
 ////////////////////////////////////////////////////////////////////////////////////////////
-#define TASK_QUEUE_SIZE 2048 // message queue size for app task
+#define TASK_QUEUE_SIZE QUEUE_MAIN_QUEUE_SIZE // message queue size for app task, see AppConfig.h
 #define TASK_PRIORITY 5
+#define MESSAGE_BATCH_BUDGET 32 // max. number of messages handled per wakeup
+#define IDLE_SLEEP_DELAY pdMS_TO_TICKS(1000) // quiet time before light sleep once idle is allowed
 
 #define LOW_POWER_COUNT 5       // in unit of seconds
 #define NO_OBJECT_COUNT (5 * 2) // (expiry seconds) x (timer frequency)
@@ -43,6 +50,10 @@ namespace freertos
     static uint8_t ucQueueStorageArea[TASK_QUEUE_SIZE * sizeof(Message)];
     static StaticQueue_t xStaticQueue;
 
+    static constexpr uint8_t PlayerButtonPins[] = PINS_SW_PLAYER;
+    static_assert(sizeof(PlayerButtonPins) / sizeof(PlayerButtonPins[0]) >= GAME_NUM_PLAYERS,
+                  "a button pin is required for each player, see PINS_SW_PLAYER in pins.h");
+
     void QueueMain::printChipInfo(void)
     {
         PRINTLN("===============================================================================");
@@ -55,20 +66,39 @@ namespace freertos
     }
 
     /////////////////////////////////////////////////////////////////////////////
-    QueueMain::QueueMain() : ardufreertos::MessageBus(TASK_QUEUE_SIZE, ucQueueStorageArea, &xStaticQueue),
-                             _debounceTimer(queue(), EventSystem, SysSoftwareTimer),
-                             _buttonBoot(queue()),
-                             _buttonPlayer1(queue()),
-                             _buttonPlayer2(queue()),
-                             handlerMap()
+    QueueMain::QueueMain() : QueueMain(std::make_index_sequence<GAME_NUM_PLAYERS>{})
+    {
+    }
+
+    template <size_t... P>
+    QueueMain::QueueMain(std::index_sequence<P...>) : ardufreertos::MessageBus(TASK_QUEUE_SIZE, ucQueueStorageArea, &xStaticQueue),
+                                                      _debounceEngine(queue(), TimerIdDebounce, this),
+                                                      _buttonBoot(queue()),
+                                                      _buttonPlayer{ButtonPlayer(PlayerButtonPins[P], queue())...},
+#ifdef APP_BUTTON_POLLING
+                                                      _buttonPoller(queue()),
+#endif
+                                                      _edgeOverflow(0),
+                                                      _batchStat{0},
+                                                      _queuePeak(0)
     {
         _instance = this;
+    }
 
-        handlerMap = {
-            __EVENT_MAP(QueueMain, EventGpioISR),
-            __EVENT_MAP(QueueMain, EventSystem),
-            __EVENT_MAP(QueueMain, EventNull), // {EventNull, &QueueMain::handlerEventNull},
-        };
+    // QueueMain runs in the Arduino loop task, call this from that task only
+    void QueueMain::printResourceUsage(void)
+    {
+        PRINTLN("QueueMain: queue peak=", _queuePeak, "/", TASK_QUEUE_SIZE,
+                ", stack free min=", uxTaskGetStackHighWaterMark(nullptr));
+    }
+
+    void QueueMain::printInputStat(void)
+    {
+#ifdef APP_BUTTON_POLLING
+        _buttonPoller.getStat().print("Input(polling)");
+#else
+        DebounceButton::getIsrStat().print("Input(ISR)");
+#endif
     }
 
     void QueueMain::start(void *ctx)
@@ -84,75 +114,167 @@ namespace freertos
         vTaskPrioritySet(taskHandle, TASK_PRIORITY);
         LOG_TRACE("uxTaskPriorityGet()=", uxTaskPriorityGet(taskHandle));
 
-        _buttonBoot.init(EventSystem, SysButtonClick, SysButtonDoubleClick, SysButtonLongPress);
-        _buttonPlayer1.init(EventSystem, SysButtonClick, SysButtonDoubleClick, SysButtonLongPress);
-        _buttonPlayer2.init(EventSystem, SysButtonClick, SysButtonDoubleClick, SysButtonLongPress);
-        _debounceTimer.attachButton(&_buttonBoot);
+#ifdef APP_TRACE
+        trace.start();
+#endif
+
+        // one row per button: players report click only, game button reports click/double click/long press
+        _debounceEngine.attach(ButtonIdGame, _buttonBoot.getPin(), _buttonBoot.getActiveState(), DebouncePolicyGesture);
+        for (uint8_t p = 0; p < GAME_NUM_PLAYERS; p++)
+        {
+            ButtonPlayer &button = _buttonPlayer[p];
+            _debounceEngine.attach((ButtonId)(ButtonIdPlayer1 + p), button.getPin(), button.getActiveState(), DebouncePolicyClick);
+        }
+
+        PowerManager *powerManager = reinterpret_cast<AppContext *>(ctx)->powerManager;
+        powerManager->init();
+        powerManager->attachWakeupPin(_buttonBoot.getPin(), _buttonBoot.getActiveState());
+        for (ButtonPlayer &button : _buttonPlayer)
+        {
+            powerManager->attachWakeupPin(button.getPin(), button.getActiveState());
+        }
+
+#ifdef APP_BUTTON_POLLING
+        _buttonPoller.attach(_buttonBoot.getPin(), _buttonBoot.getActiveState());
+        for (ButtonPlayer &button : _buttonPlayer)
+        {
+            _buttonPoller.attach(button.getPin(), button.getActiveState());
+        }
+        _buttonPoller.attachPowerManager(powerManager);
+        _buttonPoller.start();
+#endif
     }
 
-    void QueueMain::onMessage(const Message &msg)
+    // drain every pending message in one wakeup, up to MESSAGE_BATCH_BUDGET messages
+    void QueueMain::messageLoopForever(void)
     {
-        auto func = handlerMap[msg.event];
-        if (func)
+        Message msg;
+        for (;;)
         {
-            (this->*func)(msg);
+            if (xQueueReceive(queue(), &msg, IDLE_SLEEP_DELAY) != pdPASS)
+            {
+                enterLightSleep();
+                continue;
+            }
+
+            UBaseType_t occupancy = uxQueueMessagesWaiting(queue()) + 1; // including the received one
+            _queuePeak = (occupancy > _queuePeak) ? occupancy : _queuePeak;
+
+            uint32_t batch = 0;
+            do
+            {
+                onMessage(msg);
+                batch++;
+            } while (batch < MESSAGE_BATCH_BUDGET && xQueueReceive(queue(), &msg, 0) == pdPASS);
+            _batchStat.add(batch);
         }
-        else
+    }
+
+    // dispatch by switch: compiled into a jump table / compare chain, no lookup nor allocation at runtime
+    void QueueMain::onMessage(const Message &msg)
+    {
+        switch (msg.event)
         {
+        case EventGpioISR:
+            handlerEventGpioISR(msg);
+            break;
+        case EventSystem:
+            handlerEventSystem(msg);
+            break;
+        case EventNull:
+            handlerEventNull(msg);
+            break;
+        default:
             LOG_TRACE("Unsupported event=", msg.event, ", iParam=", msg.iParam, ", uParam=", msg.uParam, ", lParam=", msg.lParam);
+            break;
         }
     }
 
     /////////////////////////////////////////////////////////////////////////////
     __EVENT_FUNC_DEFINITION(QueueMain, EventGpioISR, msg) // void QueueMain::handlerEventGpioISR(const Message &msg)
     {
-        uint8_t pin = msg.iParam;
-        uint8_t value = msg.uParam;
-        uint32_t time = msg.lParam;
-
-        if (pin == _buttonBoot.getPin())
+        // drain all pending edges in one batch, then handle them in order of capture time
+        DebounceButton::beginDrainEdges();
+        uint32_t count;
+        do
         {
-            uint32_t ms = msg.lParam;
-            _buttonBoot.onEventIsr(value, ms);
-        }
-        else if (pin == _buttonPlayer1.getPin())
-        {
-            if (value == _buttonPlayer1.getActiveState())
+            count = 0;
+            while (count < GPIO_EDGE_RING_SIZE && DebounceButton::popEdge(_edgeBatch[count]))
             {
-                _buttonPlayer1.edgeFallingTime = time;
+                count++;
             }
-            else
+            sortEdges(_edgeBatch, count);
+            for (uint32_t i = 0; i < count; i++)
             {
-                auto edgeFallingTime = _buttonPlayer1.edgeFallingTime;
-                auto delta = (time > edgeFallingTime) ? (time - edgeFallingTime) : (edgeFallingTime - time);
-                if (delta > MIN_DEBOUNCE_TIME)
-                {
-                    auto ctx = reinterpret_cast<AppContext *>(context());
-                    postEvent(ctx->threadGame, EventUser, UserClick, ButtonId::ButtonIdPlayer1);
-                }
+                handlerGpioEdge(_edgeBatch[i]);
             }
+        } while (count == GPIO_EDGE_RING_SIZE);
+
+        uint32_t overflow = DebounceButton::getEdgeOverflow();
+        if (overflow != _edgeOverflow)
+        {
+            LOG_WARN("GPIO edge ring overflow=", overflow);
+            _edgeOverflow = overflow;
         }
-        else if (pin == _buttonPlayer2.getPin())
+    }
+
+    void QueueMain::handlerGpioEdge(const GpioEdge &edge)
+    {
+        if (!_debounceEngine.onEdge(edge))
         {
-            if (value == _buttonPlayer2.getActiveState())
-            {
-                _buttonPlayer2.edgeFallingTime = time;
-            }
-            else
+            LOG_TRACE("unsupported button: GPIO", edge.pin);
+        }
+    }
+
+    void QueueMain::onButtonGesture(ButtonId id, UserTriggerSource gesture, uint32_t timestamp)
+    {
+        TRACE(TraceGesture, id, gesture);
+        if (timestamp != 0)
+        {
+            clickLatency.isrToQueueMain.add(elapsedUs(timestamp));
+        }
+        if (id == ButtonIdGame && gesture == UserDoubleClick)
+        {
+            _batchStat.print("QueueMain");
+            printResourceUsage();
+            printInputStat();
+            reinterpret_cast<AppContext *>(context())->powerManager->print();
+        }
+
+        auto ctx = reinterpret_cast<AppContext *>(context());
+        postEvent(ctx->threadGame, EVENT_ARGS(UserInput{gesture, id, timestamp}));
+    }
+
+    // called after IDLE_SLEEP_DELAY without messages
+    void QueueMain::enterLightSleep(void)
+    {
+        PowerManager *powerManager = reinterpret_cast<AppContext *>(context())->powerManager;
+        if (!powerManager->isIdleAllowed() || !_debounceEngine.isIdle())
+        {
+            return;
+        }
+
+#ifdef APP_BUTTON_POLLING
+        _buttonPoller.pause();
+        powerManager->lightSleep();
+        _buttonPoller.resume(); // the integrators pick up the button which woke the chip up
+#else
+        powerManager->lightSleep();
+
+        // the edge which woke the chip up is not seen by the ISR, feed the engine with the current level instead
+        auto feedIfActive = [this](DebounceButton &button)
+        {
+            if (button.read() == button.getActiveState())
             {
-                auto edgeFallingTime = _buttonPlayer2.edgeFallingTime;
-                auto delta = (time > edgeFallingTime) ? (time - edgeFallingTime) : (edgeFallingTime - time);
-                if (delta > MIN_DEBOUNCE_TIME)
-                {
-                    auto ctx = reinterpret_cast<AppContext *>(context());
-                    postEvent(ctx->threadGame, EventUser, UserClick, ButtonId::ButtonIdPlayer2);
-                }
+                handlerGpioEdge(GpioEdge{captureEdgeTime(), button.getPin(), button.getActiveState()});
             }
-        }
-        else
+        };
+        feedIfActive(_buttonBoot);
+        for (ButtonPlayer &button : _buttonPlayer)
         {
-            LOG_TRACE("unsupported button: GPIO", pin);
+            feedIfActive(button);
         }
+#endif
     }
 
     __EVENT_FUNC_DEFINITION(QueueMain, EventSystem, msg) // void QueueMain::handlerEventSystem(const Message &msg)
@@ -161,23 +283,8 @@ namespace freertos
         switch (src)
         {
         case SysSoftwareTimer:
-            handlerSoftwareTimer((TimerHandle_t)(msg.lParam));
-            break;
-        case SysButtonClick:
-        {
-            handlerButtonClick(msg);
-            break;
-        }
-        case SysButtonDoubleClick:
-        {
-            handlerButtonDoubleClick(msg);
-            break;
-        }
-        case SysButtonLongPress:
-        {
-            handlerButtonLongPress(msg);
+            handlerSoftwareTimer(TimerTick::decode(msg).id);
             break;
-        }
         default:
             LOG_TRACE("unsupported SystemTriggerSource=", src);
             break;
@@ -191,15 +298,15 @@ namespace freertos
     }
     /////////////////////////////////////////////////////////////////////////////
 
-    void QueueMain::handlerSoftwareTimer(TimerHandle_t xTimer)
+    void QueueMain::handlerSoftwareTimer(TimerId id)
     {
-        if (xTimer == _debounceTimer.timer())
+        if (id == TimerIdDebounce)
         {
-            _debounceTimer.onEventTimer();
+            _debounceEngine.onEventTimer();
         }
         else
         {
-            LOG_TRACE("unsupported timer handle=0x%04x", (uint32_t)(xTimer));
+            LOG_TRACE("unsupported TimerId=", id);
         }
     }
 
@@ -214,50 +321,6 @@ namespace freertos
         }
     }
 
-    void QueueMain::handlerButtonClick(const Message &msg)
-    {
-        int16_t pin = msg.uParam;
-        if (pin == _buttonBoot.getPin())
-        {
-            LOG_TRACE("ButtonClick: buttonBoot");
-
-            auto ctx = reinterpret_cast<AppContext *>(context());
-            postEvent(ctx->threadGame, EventUser, UserClick, ButtonId::ButtonIdGame);
-        }
-        else
-        {
-            LOG_TRACE("SysButtonClick: unsupported pin=", pin);
-        }
-    }
-    void QueueMain::handlerButtonDoubleClick(const Message &msg)
-    {
-        int16_t pin = msg.uParam;
-        if (pin == _buttonBoot.getPin())
-        {
-            LOG_TRACE("SysButtonDoubleClick: buttonBoot");
-            auto ctx = reinterpret_cast<AppContext *>(context());
-            postEvent(ctx->threadGame, EventUser, UserDoubleClick, ButtonIdGame);
-        }
-        else
-        {
-            LOG_TRACE("SysButtonDoubleClick: unsupported pin=", pin);
-        }
-    }
-    void QueueMain::handlerButtonLongPress(const Message &msg)
-    {
-        int16_t pin = msg.uParam;
-        if (pin == _buttonBoot.getPin())
-        {
-            LOG_TRACE("SysButtonLongPress: buttonBoot");
-            auto ctx = reinterpret_cast<AppContext *>(context());
-            postEvent(ctx->threadGame, EventUser, UserLongPress, ButtonIdGame);
-        }
-        else
-        {
-            LOG_TRACE("SysButtonLongPress: unsupported pin=", pin);
-        }
-    }
-
     /////////////////////////////////////////////////////////////////////////////
 
 } // namespace freertos
@@ -18,45 +18,59 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #pragma once
-#include <map>
+#include <utility>
 #include "../ArduProfFreeRTOS.h"
 #include "../AppEvent.h"
+#include "../AppMessage.h"
 #include "../peripheral/ButtonBoot.h"
-#include "../peripheral/ButtonPlayer1.h"
-#include "../peripheral/ButtonPlayer2.h"
-#include "../peripheral/button/DebounceTimer.h"
+#include "../peripheral/ButtonPlayer.h"
+#include "../peripheral/button/DebounceEngine.h"
+#include "../peripheral/button/ButtonPoller.h"
+#include "../AppConfig.h"
+#include "../util/BatchStat.h"
 
 namespace freertos
 {
-    class QueueMain final : public ardufreertos::MessageBus
+    class QueueMain final : public ardufreertos::MessageBus,
+                            public DebounceListener
     {
     public:
         QueueMain();
 
         virtual void start(void *);
         virtual void onMessage(const Message &msg) override;
+        void messageLoopForever(void);
 
-        static void printChipInfo(void);
+        virtual void onButtonGesture(ButtonId id, UserTriggerSource gesture, uint32_t timestamp) override;
 
-    protected:
-        typedef void (QueueMain::*funcPtr)(const Message &);
-        std::map<int16_t, funcPtr> handlerMap;
+        static void printChipInfo(void);
+        void printResourceUsage(void);
+        void printInputStat(void);
 
     private:
         static QueueMain *_instance;
 
-        DebounceTimer _debounceTimer;
+        // the buttons bind their ISR to `this`, so each one is constructed in place with its pin
+        template <size_t... P>
+        QueueMain(std::index_sequence<P...>);
+
+        DebounceEngine _debounceEngine;
         ButtonBoot _buttonBoot;
-        ButtonPlayer1 _buttonPlayer1;
-        ButtonPlayer2 _buttonPlayer2;
+        ButtonPlayer _buttonPlayer[GAME_NUM_PLAYERS]; // index = GamePlayer
+#ifdef APP_BUTTON_POLLING
+        ButtonPoller _buttonPoller;
+#endif
 
-        void handlerSoftwareTimer(TimerHandle_t xTimer);
+        uint32_t _edgeOverflow; // last reported overflow count of the GPIO edge ring
+        GpioEdge _edgeBatch[GPIO_EDGE_RING_SIZE]; // edges drained from the ring, sorted by capture time
+        BatchStat _batchStat;
+        UBaseType_t _queuePeak; // high-water mark of queue occupancy
 
-        void debounce(uint32_t start, uint32_t ms);
+        void handlerSoftwareTimer(TimerId id);
+        void handlerGpioEdge(const GpioEdge &edge);
+        void enterLightSleep(void);
 
-        void handlerButtonClick(const Message &msg);
-        void handlerButtonDoubleClick(const Message &msg);
-        void handlerButtonLongPress(const Message &msg);
+        void debounce(uint32_t start, uint32_t ms);
 
         // ///////////////////////////////////////////////////////////////////////
         // // declare event handler
@@ -19,10 +19,19 @@
  */
 #include "./ThreadGame.h"
 #include "../AppContext.h"
+#include "../AppConfig.h"
+#include "../AppMessage.h"
 #include "../peripheral/RoundLed.h"
+#include "../peripheral/PowerManager.h"
+#include "../util/LatencyStat.h"
+#include "../util/Trace.h"
+
+#define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_THREAD_GAME
+#include "../AppLogModule.h"
 
 // ////////////////////////////////////////////////////////////////////////////////////////////
-#define CLICKS_PER_STEP 1 // numer of clicks to advance 1 step
+#define FRAME_INTERVAL pdMS_TO_TICKS(1000 / LED_FRAME_RATE) // see AppConfig.h
+#define FRAME_DIVIDER_MAX 8
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 // Thread
@@ -32,9 +41,10 @@
 #define RUNNING_CORE ARDUINO_RUNNING_CORE
 
 #define TASK_NAME "ThreadGame"
-#define TASK_STACK_SIZE 4096
+#define TASK_STACK_SIZE THREAD_GAME_STACK_SIZE // see AppConfig.h
 #define TASK_PRIORITY 3
-#define TASK_QUEUE_SIZE 128 // message queue size for app task
+#define TASK_QUEUE_SIZE THREAD_GAME_QUEUE_SIZE // message queue size for app task, see AppConfig.h
+#define RENDER_BATCH_BUDGET 32 // max. number of messages handled before a pending render is forced
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 namespace freertos
@@ -48,6 +58,8 @@ namespace freertos
 
     static StackType_t xStack[TASK_STACK_SIZE];
     static StaticTask_t xTaskBuffer;
+
+    static uint8_t trackFrame[RoundLed::getTotalLeds()]; // composed by _animation
     ////////////////////////////////////////////////////////////////////////////////////////////
 
     ThreadGame::ThreadGame() : ThreadBase(TASK_QUEUE_SIZE, ucQueueStorageArea, &xStaticQueue),
@@ -60,46 +72,58 @@ namespace freertos
                                                  auto context = reinterpret_cast<AppContext *>(_instance->context());
                                                  if (context && context->threadGame)
                                                  {
-                                                     static_cast<freertos::ThreadGame *>(context->threadGame)->postEvent(EventSystem, SysSoftwareTimer, 0, (uint32_t)xTimer);
+                                                     static_cast<freertos::ThreadGame *>(context->threadGame)->postEvent(EVENT_ARGS(TimerTick{TimerId1Hz}));
                                                  }
                                              }
                                          }),
-                               _timerEngine("Timer GameEngine",
-                                            pdMS_TO_TICKS(125),
-                                            [](TimerHandle_t xTimer)
-                                            {
-                                                if (_instance)
-                                                {
-                                                    auto context = reinterpret_cast<AppContext *>(_instance->context());
-                                                    if (context && context->threadGame)
-                                                    {
-                                                        static_cast<freertos::ThreadGame *>(context->threadGame)->postEvent(EventSystem, SysSoftwareTimer, 0, (uint32_t)xTimer);
-                                                    }
-                                                }
-                                            }),
-                               _gameData(GameState::Stop, GamePlayer::PlayerNull, TimeSlotState::SlotGame),
-                               _playersData{0},
-                               _rLed(),
-                               handlerMap()
+                               _timerFrame("Timer Frame",
+                                           FRAME_INTERVAL,
+                                           pdTRUE, // auto-reload, runs only while animating
+                                           nullptr,
+                                           [](TimerHandle_t xTimer)
+                                           {
+                                               if (_instance)
+                                               {
+                                                   auto context = reinterpret_cast<AppContext *>(_instance->context());
+                                                   if (context && context->threadGame)
+                                                   {
+                                                       static_cast<freertos::ThreadGame *>(context->threadGame)->postEvent(EVENT_ARGS(TimerTick{TimerIdFrame}));
+                                                   }
+                                               }
+                                           }),
+                               _isFrameArmed(false),
+                               _isAnimating(false),
+                               _frameDivider(1),
+                               _frameStat{0},
+                               _renderPending(false),
+                               _gameData(GameState::Stop, GamePlayer::PlayerNull),
+                               _engine(RoundLed::getTotalLeds()),
+                               _matchLog(RoundLed::getTotalLeds()),
+                               _isMatchSavePending(false),
+                               _rLed(queue()),
+                               _animation(RoundLed::getTotalLeds()),
+                               _batchCount(0),
+                               _batchStat{0},
+                               _queuePeak(0)
     {
         _instance = this;
-
-        handlerMap = {
-            __EVENT_MAP(ThreadGame, EventUser),
-            __EVENT_MAP(ThreadGame, EventSystem),
-            __EVENT_MAP(ThreadGame, EventNull), // {EventNull, &ThreadGame::handlerEventNull},
-        };
     }
 
     __EVENT_FUNC_DEFINITION(ThreadGame, EventUser, msg) // void ThreadGame::handlerEventUser(const Message &msg)
     {
-        UserTriggerSource src = (UserTriggerSource)(msg.iParam);
-        ButtonId id = (ButtonId)(msg.uParam);
+        UserInput input = UserInput::decode(msg);
+        UserTriggerSource src = input.source;
+        ButtonId id = input.button;
+        uint32_t timestamp = input.timestamp;
         switch (src)
         {
         case UserClick:
-            LOG_TRACE("UserClick: id=", id);
-            handlerUserClick(id);
+            if (timestamp)
+            {
+                clickLatency.isrToThreadGame.add(elapsedUs(timestamp));
+            }
+            TRACE(TraceUserClick, id, timestamp);
+            handlerUserClick(id, timestamp);
             break;
         case UserDoubleClick:
             handlerUserDoubleClick(id);
@@ -118,7 +142,12 @@ namespace freertos
         switch (src)
         {
         case SysSoftwareTimer:
-            handlerSoftwareTimer((TimerHandle_t)(msg.lParam));
+            handlerSoftwareTimer(TimerTick::decode(msg).id);
+            break;
+        case SysLedTxDone:
+            _rLed.onTxDone();
+            onFrameShown(LedTxDone::decode(msg).timestamp);
+            updatePowerState();
             break;
         default:
             LOG_TRACE("unsupported SystemTriggerSource=", src);
@@ -131,16 +160,38 @@ namespace freertos
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////
+    // dispatch by switch: compiled into a jump table / compare chain, no lookup nor allocation at runtime
     void ThreadGame::onMessage(const Message &msg)
     {
-        auto func = handlerMap[msg.event];
-        if (func)
+        switch (msg.event)
         {
-            (this->*func)(msg);
+        case EventUser:
+            handlerEventUser(msg);
+            break;
+        case EventSystem:
+            handlerEventSystem(msg);
+            break;
+        case EventNull:
+            handlerEventNull(msg);
+            break;
+        default:
+            LOG_DEBUG("Unsupported event = ", msg.event, ", iParam = ", msg.iParam, ", uParam = ", msg.uParam, ", lParam = ", msg.lParam);
+            break;
         }
-        else
+
+        // coalesce: consecutive clicks in the queue are applied first, then rendered once
+        _batchCount++;
+        UBaseType_t waiting = uxQueueMessagesWaiting(queue());
+        _queuePeak = (waiting + 1 > _queuePeak) ? waiting + 1 : _queuePeak; // including the handled one
+        bool isQueueEmpty = (waiting == 0);
+        if (_renderPending && (isQueueEmpty || (_batchCount % RENDER_BATCH_BUDGET) == 0))
         {
-            LOG_DEBUG("Unsupported event = ", msg.event, ", iParam = ", msg.iParam, ", uParam = ", msg.uParam, ", lParam = ", msg.lParam);
+            render();
+        }
+        if (isQueueEmpty)
+        {
+            _batchStat.add(_batchCount);
+            _batchCount = 0;
         }
     }
 
@@ -161,13 +212,25 @@ namespace freertos
             RUNNING_CORE);
     }
 
+    void ThreadGame::printResourceUsage(void)
+    {
+        PRINTLN("ThreadGame: queue peak=", _queuePeak, "/", TASK_QUEUE_SIZE,
+                ", stack free min=", uxTaskGetStackHighWaterMark(_taskHandle), "/", TASK_STACK_SIZE);
+        PRINTLN("RoundLedTx: stack free min=", _rLed.getTxStackHighWaterMark(), "/", LED_TX_STACK_SIZE);
+    }
+
     void ThreadGame::setup(void)
     {
         LOG_TRACE("on core ", xPortGetCoreID(), ", uxTaskPriorityGet()=", uxTaskPriorityGet(xTaskGetCurrentTaskHandle()), ", xPortGetFreeHeapSize()=", xPortGetFreeHeapSize());
         ThreadBase::setup();
 
         _rLed.init();
-        _timerEngine.start();
+        _matchLog.load(); // the last match of the previous run can be replayed
+        render(); // show the initial frame, further frames are drawn on events only
+
+#ifdef APP_BENCHMARK
+        runBenchmark();
+#endif
     }
 
     void ThreadGame::run(void)
@@ -185,27 +248,28 @@ namespace freertos
         //////////////////////////////////////////////////////////////
     }
 
-    void ThreadGame::handlerSoftwareTimer(TimerHandle_t xTimer)
+    void ThreadGame::handlerSoftwareTimer(TimerId id)
     {
-        if (xTimer == _timer1Hz.timer())
+        switch (id)
         {
+        case TimerId1Hz:
             LOG_TRACE("_timer1Hz");
-        }
-        else if (xTimer == _timerEngine.timer())
-        {
-            updateState();
-            updateUi();
-        }
-        else
-        {
-            LOG_WARN("unsupported timer handle=0x%04x", DebugLogBase::HEX, (uint32_t)(xTimer));
+            break;
+        case TimerIdFrame:
+            if (_isAnimating)
+            {
+                requestRender();
+            }
+            break;
+        default:
+            LOG_WARN("unsupported TimerId=", id);
+            break;
         }
     }
 
-    void ThreadGame::handlerUserClick(ButtonId id)
+    void ThreadGame::handlerUserClick(ButtonId id, uint32_t timestamp)
     {
         GameData &gameData = _gameData;
-        PlayerData *playersData = _playersData;
 
         switch (id)
         {
@@ -224,28 +288,47 @@ namespace freertos
             }
             break;
 
-        case ButtonId::ButtonIdPlayer1:
-            if (gameData.state == GameState::Start)
+        default:
+        {
+            // player buttons: ButtonIdPlayer1 + GamePlayer
+            uint8_t player = (uint8_t)(id - ButtonId::ButtonIdPlayer1);
+            if (id < ButtonId::ButtonIdPlayer1 || player >= _engine.getNumPlayers())
             {
-                advancePlayerPosition(playersData[GamePlayer::Player1]);
+                LOG_WARN("unsupported ButtonId=%d", id);
             }
-            break;
-
-        case ButtonId::ButtonIdPlayer2:
-            if (gameData.state == GameState::Start)
+            else if (gameData.state == GameState::Start)
             {
-                advancePlayerPosition(playersData[GamePlayer::Player2]);
+                _matchLog.append(MatchRecordInput, player, timestamp);
+                GamePlayer leader = _engine.getLeader();
+                if (_engine.advance((GamePlayer)player))
+                {
+                    if (_engine.getLeader() != leader)
+                    {
+                        TRACE(TraceOvertake, _engine.getLeader(), leader);
+                    }
+                    _animation.setTarget(player, _engine.getPosition((GamePlayer)player));
+                    onPositionChanged(timestamp);
+                    requestRender();
+                }
             }
             break;
-
-        default:
-            LOG_WARN("unsupported ButtonId=%d", id);
-            break;
+        }
         }
     }
     void ThreadGame::handlerUserDoubleClick(ButtonId id)
     {
         LOG_TRACE("ButtonId=", id);
+        if (id == ButtonId::ButtonIdGame)
+        {
+            clickLatency.print();
+            PRINTLN("RoundLed: framesSent=", _rLed.getFramesSent(), ", framesSkipped=", _rLed.getFramesSkipped());
+            PRINTLN("RoundLed: budget=", LED_POWER_BUDGET_MA, "mA, framesLimited=", _rLed.getFramesLimited(),
+                    ", lastCurrent=", _rLed.getLastCurrentMa(), "mA, peakCurrent=", _rLed.getPeakCurrentMa(), "mA");
+            PRINTLN("GameEngine: players=", _engine.getNumPlayers(), ", leader=", _engine.getLeader(), ", overtakes=", _engine.getOvertakes());
+            _batchStat.print("ThreadGame");
+            _frameStat.print("Animation", LED_FRAME_BUDGET_US, _frameDivider);
+            printResourceUsage();
+        }
     }
     void ThreadGame::handlerUserLongPress(ButtonId id)
     {
@@ -260,6 +343,10 @@ namespace freertos
             {
                 stopGame();
             }
+            else if (gameData.state == GameState::Stop)
+            {
+                _matchLog.replay(); // replay the last match
+            }
             break;
 
         default:
@@ -269,51 +356,119 @@ namespace freertos
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////
+    // frames are drawn on demand: a state change requests a render, which runs once the current message is handled
+    void ThreadGame::requestRender(void)
+    {
+        _renderPending = true;
+    }
+
+    void ThreadGame::render(void)
+    {
+        _renderPending = false;
+        updateState();
+        if (_gameData.state != GameState::Stop || _isAnimating)
+        {
+            // leave idle before updateUi(), so the new frame is sent at full speed
+            reinterpret_cast<AppContext *>(context())->powerManager->setIdleAllowed(false);
+        }
+        updateUi();
+        updateFrameTimer();
+        updatePowerState();
+    }
+
+    // the frame timer runs only while animating, it is not armed in the idle path (stop, once the win effect ends)
+    void ThreadGame::updateFrameTimer(void)
+    {
+        if (_isAnimating)
+        {
+            if (!_isFrameArmed)
+            {
+                // as xTimerStart(): changing the period starts the dormant timer
+                _timerFrame.changePeriod(FRAME_INTERVAL * _frameDivider);
+                _isFrameArmed = true;
+            }
+        }
+        else if (_isFrameArmed)
+        {
+            _timerFrame.stop();
+            _isFrameArmed = false;
+        }
+    }
+
+    // a frame over budget halves the frame rate, a frame well within it doubles the rate back.
+    // the period of the frame timer follows, no tick is wasted on a skipped frame
+    void ThreadGame::updateFrameBudget(uint32_t composeUs)
+    {
+        _frameStat.add(composeUs, LED_FRAME_BUDGET_US);
+        uint8_t divider = _frameDivider;
+        if (composeUs > LED_FRAME_BUDGET_US && divider < FRAME_DIVIDER_MAX)
+        {
+            divider *= 2;
+        }
+        else if (composeUs < LED_FRAME_BUDGET_US / 4 && divider > 1)
+        {
+            divider /= 2;
+        }
+        if (divider != _frameDivider)
+        {
+            _frameDivider = divider;
+            if (_isFrameArmed) // a dormant timer gets its period when armed
+            {
+                _timerFrame.changePeriod(FRAME_INTERVAL * _frameDivider);
+            }
+        }
+    }
+
+    // idle (light sleep allowed) once the game is stopped and its frame is on the LEDs,
+    // nothing is periodic then: the blink timer is stopped and frames are drawn on events only
+    void ThreadGame::updatePowerState(void)
+    {
+        bool isIdle = (_gameData.state == GameState::Stop) && !_renderPending && !_isAnimating && _rLed.isTxIdle();
+        if (isIdle)
+        {
+            saveMatch(); // off the click path: the final frame is on the LEDs and nothing is animated
+        }
+        reinterpret_cast<AppContext *>(context())->powerManager->setIdleAllowed(isIdle);
+    }
+
     void ThreadGame::updateState(void)
     {
         GameData &gameData = _gameData;
-        PlayerData *playersData = _playersData;
         switch (gameData.state)
         {
         case GameState::Start:
         {
-            PlayerData &player1 = playersData[GamePlayer::Player1];
-            PlayerData &player2 = playersData[GamePlayer::Player2];
-            if (player1.position == player2.position)
+            GamePlayer winner = _engine.getWinner();
+            if (winner != GamePlayer::PlayerNull)
             {
-                if (player1.countLoop > player2.countLoop)
-                {
-                    gameData.winner = GamePlayer::Player1;
-                    gameData.state = GameState::Stop;
-                    LOG_TRACE("Player1 win");
-                }
-                else if (player1.countLoop < player2.countLoop)
-                {
-                    gameData.winner = GamePlayer::Player2;
-                    gameData.state = GameState::Stop;
-                    LOG_TRACE("Player2 win");
-                }
+                gameData.winner = winner;
+                gameData.state = GameState::Stop;
+                TRACE(TracePlayerWin, winner, 0);
+                _animation.play(AnimationWin, millis(), winner);
+                endMatch(winner);
             }
             break;
         }
         }
     }
 
-    void ThreadGame::advancePlayerPosition(PlayerData &player)
+    // latency of a click is measured up to the end of the transmission of the frame which draws it:
+    // the frame being composed is tagged with the click, the tag comes back with its SysLedTxDone
+    void ThreadGame::onPositionChanged(uint32_t timestamp)
     {
-        if (++player.countClick >= CLICKS_PER_STEP)
+        if (timestamp)
         {
-            uint16_t totalLeds = _rLed.getTotalLeds();
-            player.countClick = 0;
-            if (player.position < (totalLeds - 1))
-            {
-                player.position++;
-            }
-            else
-            {
-                player.position = 0;
-                player.countLoop++;
-            }
+            clickLatency.isrToPosition.add(elapsedUs(timestamp));
+            _rLed.tagFrame(timestamp);
+        }
+    }
+
+    // timestamp: tag of the transmitted frame, 0 if it draws no measured click
+    void ThreadGame::onFrameShown(uint32_t timestamp)
+    {
+        if (timestamp)
+        {
+            clickLatency.isrToShow.add(elapsedUs(timestamp));
         }
     }
 
@@ -326,30 +481,21 @@ namespace freertos
     // | green on         | game pause | player1 position             |
     // | blue on (all)    | game stop  | player2 win                  |
     // | blue on          | game pause | player2 position             |
-    // | green/blue blink | game start | player1 and player2 position |
+    // | green/blue pulse | game start | player1 and player2 position |
     // +------------------+------------+------------------------------+
     void ThreadGame::updateUi(void)
     {
-        static bool toggle = false;
-
         GameData &gameData = _gameData;
-        PlayerData *playersData = _playersData;
-
-        int slot = (int)gameData.timeSlotState;
-        slot = slot < (int)(SlotMaxValue - 1) ? slot + 1 : 0;
-        gameData.timeSlotState = (TimeSlotState)(slot);
 
         switch (gameData.state)
         {
         case GameState::Start:
-            uiStateStart(gameData, playersData);
+        case GameState::Pause:
+            uiStateAnimation();
             break;
         case GameState::Stop:
             uiStateStop(gameData);
             break;
-        case GameState::Pause:
-            uiStatePause(playersData);
-            break;
         default:
             LOG_WARN("unsupported gameData.state=", (int32_t)(gameData.state));
             uiStateUnknown();
@@ -357,98 +503,106 @@ namespace freertos
         }
     }
 
-    // blink leds according to player position
-    void ThreadGame::uiStateStart(GameData &gameData, PlayerData playersData[])
-    {
-        uint16_t player1Position = playersData[GamePlayer::Player1].position;
-        uint16_t player2Position = playersData[GamePlayer::Player2].position;
-
-        _rLed.clearBuf();
-        _rLed.setPlayer1LedBuf(player1Position, gameData.timeSlotState == TimeSlotState::SlotPlayer1);
-        _rLed.setPlayer2LedBuf(player2Position, gameData.timeSlotState == TimeSlotState::SlotPlayer2);
-        _rLed.uiShow();
-    }
-
-    // show leds according to player position
-    void ThreadGame::uiStatePause(PlayerData playersData[])
+    // the next frame of the animation: player markers gliding to their position, or the win effect
+    void ThreadGame::uiStateAnimation(void)
     {
-        uint16_t player1Position = playersData[GamePlayer::Player1].position;
-        uint16_t player2Position = playersData[GamePlayer::Player2].position;
-
-        _rLed.clearBuf();
-        _rLed.setPlayer1LedBuf(player1Position, true);
-        _rLed.setPlayer2LedBuf(player2Position, true);
-        _rLed.uiShow();
+        uint32_t composeStart = micros();
+        _isAnimating = _animation.compose(trackFrame, millis());
+        _rLed.uiShowFade(trackFrame, _animation.getMixSlots(), _animation.getMixCount());
+        updateFrameBudget(micros() - composeStart);
     }
 
     void ThreadGame::uiStateStop(GameData &gameData)
     {
-        switch (gameData.winner)
-        {
-        case GamePlayer::PlayerNull:
+        if (gameData.winner == GamePlayer::PlayerNull)
         {
+            _isAnimating = false;
             _rLed.setGameLed(true);
-            break;
         }
-        case GamePlayer::Player1:
+        else if (gameData.winner < _engine.getNumPlayers())
         {
-            _rLed.uiGamePlayer1Win();
-            break;
+            if (_animation.isActive())
+            {
+                uiStateAnimation(); // its last frame equals the win pattern
+            }
+            else
+            {
+                _isAnimating = false;
+                _rLed.uiGamePlayerWin(gameData.winner);
+            }
         }
-        case GamePlayer::Player2:
+        else
         {
-            _rLed.uiGamePlayer2Win();
-            break;
-        }
-        default:
             LOG_WARN("unsupported gameData.winner=", gameData.winner);
             uiStateUnknown();
-            break;
         }
     }
     void ThreadGame::uiStateUnknown(void)
     {
+        _isAnimating = false;
         _rLed.uiClear();
     }
 
-    void ThreadGame::startGame(void)
+    void ThreadGame::startGame(uint8_t numPlayers)
     {
-        resetPlayersData();
+        saveMatch(); // restarted before the LEDs of the last match settled
+        _engine.reset(numPlayers);
+        _matchLog.begin();
+        _matchLog.append(MatchRecordStart, _engine.getNumPlayers(), micros());
 
         GameData &gameData = _gameData;
         gameData.state = GameState::Start;
         gameData.winner = GamePlayer::PlayerNull;
-        gameData.timeSlotState = TimeSlotState::SlotGame;
+        _animation.reset(_engine.getNumPlayers());
+        _animation.play(AnimationRun, millis());
+        TRACE(TraceGameState, GameState::Start, 0);
+        requestRender();
     }
     void ThreadGame::stopGame(void)
     {
         GameData &gameData = _gameData;
         gameData.state = GameState::Stop;
+        endMatch(GamePlayer::PlayerNull);
+        TRACE(TraceGameState, GameState::Stop, 0);
+        requestRender();
     }
     void ThreadGame::pauseGame(void)
     {
         GameData &gameData = _gameData;
         gameData.state = GameState::Pause;
+        _matchLog.append(MatchRecordPause, 0, micros());
+        _animation.play(AnimationPause, millis());
+        TRACE(TraceGameState, GameState::Pause, 0);
+        requestRender();
     }
     void ThreadGame::resumeGame(void)
     {
         GameData &gameData = _gameData;
         gameData.state = GameState::Start;
+        _matchLog.append(MatchRecordResume, 0, micros());
+        _animation.play(AnimationRun, millis());
+        TRACE(TraceGameState, GameState::Start, 0);
+        requestRender();
     }
 
-    void ThreadGame::resetPlayersData(void)
+    // the match is saved to NVS once it ends, a long press on button "Game" in stop state replays it
+    void ThreadGame::endMatch(GamePlayer winner)
     {
-        PlayerData *playersData = _playersData;
-
-        PlayerData &player1 = playersData[GamePlayer::Player1];
-        player1.countClick = 0;
-        player1.countLoop = 0;
-        player1.position = 0;
+        _matchLog.append(MatchRecordStop, winner, micros());
+        _isMatchSavePending = true;
+    }
 
-        PlayerData &player2 = playersData[GamePlayer::Player2];
-        player2.countClick = 0;
-        player2.countLoop = 0;
-        player2.position = 0;
+    // the NVS write takes milliseconds: it never runs between a state change and its frame
+    void ThreadGame::saveMatch(void)
+    {
+        if (_isMatchSavePending)
+        {
+            _isMatchSavePending = false;
+            if (!_matchLog.save())
+            {
+                LOG_WARN("failed to save the match log");
+            }
+        }
     }
 
 } // namespace freertos
\ No newline at end of file
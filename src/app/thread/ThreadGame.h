@@ -18,12 +18,16 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #pragma once
-#include <map>
 #include "../ArduProfFreeRTOS.h"
+#include "../AppConfig.h"
 #include "../AppEvent.h"
 #include "../game/GameData.h"
-#include "../game/PlayerData.h"
+#include "../game/GameEngine.h"
+#include "../game/MatchLog.h"
+#include "../peripheral/LedAnimation.h"
 #include "../peripheral/RoundLed.h"
+#include "../util/BatchStat.h"
+#include "../util/FrameStat.h"
 
 namespace freertos
 {
@@ -34,8 +38,6 @@ namespace freertos
         virtual void start(void *);
 
     protected:
-        typedef void (ThreadGame::*handlerFunc)(const Message &);
-        std::map<int16_t, handlerFunc> handlerMap;
         virtual void onMessage(const Message &msg);
 
         virtual void run(void);
@@ -46,34 +48,57 @@ namespace freertos
         TaskHandle_t _taskInitHandle;
 
         ardufreertos::PeriodicTimer _timer1Hz;
-        ardufreertos::PeriodicTimer _timerEngine;
+        ardufreertos::SoftwareTimer _timerFrame;
+        bool _isFrameArmed;
+        bool _isAnimating;     // the last composed frame is not the final one
+        uint8_t _frameDivider; // period of _timerFrame in FRAME_INTERVAL
+        FrameStat _frameStat;
+        bool _renderPending;
 
         GameData _gameData;
-        PlayerData _playersData[GamePlayer::NumPlayer];
+        GameEngine _engine;
+        MatchLog _matchLog;
+        bool _isMatchSavePending; // the match has ended, its log is saved once the LEDs are static
         RoundLed _rLed;
+        LedAnimation _animation;
+
+        uint32_t _batchCount; // messages handled since the queue was last empty
+        BatchStat _batchStat;
+        UBaseType_t _queuePeak; // high-water mark of queue occupancy
+
+        void printResourceUsage(void);
+#ifdef APP_BENCHMARK
+        void runBenchmark(void);
+#endif
 
         virtual void setup(void);
         virtual void delayInit(void);
 
-        void handlerSoftwareTimer(TimerHandle_t xTimer);
-        void handlerUserClick(ButtonId id);
+        void handlerSoftwareTimer(TimerId id);
+        void handlerUserClick(ButtonId id, uint32_t timestamp);
         void handlerUserDoubleClick(ButtonId id);
         void handlerUserLongPress(ButtonId id);
+        void requestRender(void);
+        void render(void);
+        void updateFrameTimer(void);
+        void updateFrameBudget(uint32_t composeUs);
+        void updatePowerState(void);
         void updateState(void);
         void updateUi(void);
 
-        void uiStateStart(GameData &gameData, PlayerData playersData[]);
-        void uiStatePause(PlayerData playersData[]);
+        void uiStateAnimation(void);
         void uiStateStop(GameData &gameData);
         void uiStateUnknown(void);
 
-        void startGame(void);
+        void startGame(uint8_t numPlayers = GAME_NUM_PLAYERS);
         void stopGame(void);
         void pauseGame(void);
         void resumeGame(void);
+        void endMatch(GamePlayer winner);
+        void saveMatch(void);
 
-        void resetPlayersData(void);
-        void advancePlayerPosition(PlayerData &player);
+        void onPositionChanged(uint32_t timestamp);
+        void onFrameShown(uint32_t timestamp);
 
         ///////////////////////////////////////////////////////////////////////
         // declare event handler
@@ -0,0 +1,111 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "../AppConfig.h"
+#ifdef APP_BENCHMARK
+#include <algorithm>
+#include <esp_heap_caps.h>
+#include "./ThreadGame.h"
+#include "../AppContext.h"
+#include "../AppMessage.h"
+
+#define APP_LOG_MODULE_LEVEL APP_LOG_LEVEL_THREAD_GAME
+#include "../AppLogModule.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// on-target benchmark of the click path: handlerEventUser -> GameEngine::advance -> render
+// (updateState, updateUi). synthetic clicks go round-robin over the players, so nobody wins,
+// and a frame is rendered every `clicksPerRender` clicks, as when clicks are coalesced in a busy queue:
+// at LED_FRAME_RATE frames/s this is a click rate of clicksPerRender * LED_FRAME_RATE clicks/s.
+// one JSON object per line is printed for each (players, clicksPerRender) case.
+// the compose time of LedAnimation is benchmarked on the host, see host/test/bench_compose.cpp
+////////////////////////////////////////////////////////////////////////////////////////////
+#define BENCH_EVENTS 1024
+
+static uint32_t benchCycles[BENCH_EVENTS];
+static const uint8_t benchClicksPerRender[] = {1, 4, 16};
+
+static uint32_t getAllocatedBlocks(void)
+{
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_DEFAULT);
+    return info.allocated_blocks;
+}
+
+namespace freertos
+{
+    void ThreadGame::runBenchmark(void)
+    {
+        for (uint8_t players = 2; players <= GameEngine::getMaxPlayers(); players++)
+        {
+            for (uint8_t clicksPerRender : benchClicksPerRender)
+            {
+                startGame(players);
+                render();
+
+                uint32_t blocks = getAllocatedBlocks();
+                uint32_t cyclesStart = ESP.getCycleCount(); // not micros(): on the host it is simulated time
+                for (uint32_t i = 0; i < BENCH_EVENTS; i++)
+                {
+                    EventParams params = UserInput{UserClick, (ButtonId)(ButtonIdPlayer1 + i % players), 0}.encode();
+                    Message msg;
+                    msg.event = params.event;
+                    msg.iParam = params.iParam;
+                    msg.uParam = params.uParam;
+                    msg.lParam = params.lParam;
+
+                    uint32_t cycles = ESP.getCycleCount();
+                    handlerEventUser(msg);
+                    if (((i + 1) % clicksPerRender) == 0 && _renderPending)
+                    {
+                        render();
+                    }
+                    benchCycles[i] = ESP.getCycleCount() - cycles;
+                }
+                double elapsedUs = (double)(ESP.getCycleCount() - cyclesStart) / ESP.getCpuFreqMHz();
+                int32_t blocksDelta = (int32_t)(getAllocatedBlocks() - blocks); // net, all tasks included
+
+                std::sort(benchCycles, benchCycles + BENCH_EVENTS);
+                char line[256];
+                snprintf(line, sizeof(line),
+                         "{\"benchmark\":\"engine\",\"players\":%u,\"clicksPerRender\":%u,\"clicksPerSec\":%u,\"events\":%u,"
+                         "\"eventsPerSec\":%.0f,\"cyclesP50\":%u,\"cyclesP90\":%u,\"cyclesP99\":%u,\"cyclesMax\":%u,"
+                         "\"allocPerEvent\":%.3f}",
+                         players, clicksPerRender, clicksPerRender * LED_FRAME_RATE, BENCH_EVENTS,
+                         elapsedUs > 0 ? BENCH_EVENTS * 1000000 / elapsedUs : 0.0,
+                         benchCycles[BENCH_EVENTS / 2], benchCycles[BENCH_EVENTS * 90 / 100],
+                         benchCycles[BENCH_EVENTS * 99 / 100], benchCycles[BENCH_EVENTS - 1],
+                         (double)blocksDelta / BENCH_EVENTS);
+                PRINTLN(line);
+                _isMatchSavePending = false; // a synthetic match is never saved
+            }
+        }
+
+        // back to the state after boot, without saving the synthetic match
+        _engine.reset();
+        _gameData = GameData{GameState::Stop, GamePlayer::PlayerNull};
+        _animation.reset();
+        _isAnimating = false;
+        _isMatchSavePending = false;
+        _matchLog.load();
+        render();
+    }
+} // namespace freertos
+
+#endif // APP_BENCHMARK
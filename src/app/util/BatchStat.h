@@ -0,0 +1,44 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "../ArduProfFreeRTOS.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// number of messages handled per wakeup of a message loop
+/////////////////////////////////////////////////////////////////////////////
+typedef struct _BatchStat
+{
+    uint32_t wakeups;
+    uint32_t messages;
+    uint32_t maxBatch;
+
+    void add(uint32_t batch)
+    {
+        wakeups++;
+        messages += batch;
+        maxBatch = (batch > maxBatch) ? batch : maxBatch;
+    }
+
+    void print(const char *name) const
+    {
+        PRINTLN(name, ": wakeups=", wakeups, ", messages=", messages,
+                ", messages/wakeup=", wakeups ? (float)messages / wakeups : 0.0f, ", maxBatch=", maxBatch);
+    }
+} BatchStat;
@@ -0,0 +1,46 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "../ArduProfFreeRTOS.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// time spent composing animation frames (in unit of us) against a per-frame budget
+/////////////////////////////////////////////////////////////////////////////
+typedef struct _FrameStat
+{
+    uint32_t frames;
+    uint32_t overBudget;
+    uint32_t totalUs;
+    uint32_t maxUs;
+
+    void add(uint32_t us, uint32_t budgetUs)
+    {
+        frames++;
+        totalUs += us;
+        maxUs = (us > maxUs) ? us : maxUs;
+        overBudget += (us > budgetUs) ? 1 : 0;
+    }
+
+    void print(const char *name, uint32_t budgetUs, uint8_t divider) const
+    {
+        PRINTLN(name, ": frames=", frames, ", us/frame=", frames ? (float)totalUs / frames : 0.0f,
+                ", maxUs=", maxUs, ", budgetUs=", budgetUs, ", overBudget=", overBudget, ", frameDivider=", divider);
+    }
+} FrameStat;
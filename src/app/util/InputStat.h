@@ -0,0 +1,40 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include "../ArduProfFreeRTOS.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// cost of button input: number of ISR calls (or poll samples), edges queued and CPU time spent,
+// and EventGpioISR which could not be queued as the queue was full
+// updated by one producer (GPIO ISR or poll timer), read by QueueMain for printing only
+/////////////////////////////////////////////////////////////////////////////
+typedef struct _InputStat
+{
+    uint32_t calls;
+    uint32_t edges;
+    uint32_t busyUs;
+    uint32_t notifyLost;
+
+    void print(const char *name) const
+    {
+        PRINTLN(name, ": calls=", calls, ", edges=", edges, ", busy=", busyUs, "us",
+                ", us/call=", calls ? (float)busyUs / calls : 0.0f, ", notify lost=", notifyLost);
+    }
+} InputStat;
@@ -17,55 +17,37 @@
  * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
-#include <string.h>
-#include "DebounceTimer.h"
-#include "DebounceButton.h"
+#include "../ArduProfFreeRTOS.h"
+#include "./LatencyStat.h"
 
-DebounceTimer *DebounceTimer::_instance = nullptr;
+ClickLatency clickLatency;
 
-bool DebounceTimer::attachButton(DebounceButton *button)
+void LatencyHistogram::print(const char *name) const
 {
-    for (int i = 0; i < ButtonListSize; i++)
+    PRINTLN(name, ": count=", _count, ", min=", min(), "us, mean=", mean(), "us, max=", _max, "us");
+    for (uint8_t i = 0; i < NumBucket; i++)
     {
-        if (_buttonList[i] == nullptr)
+        if (_bucket[i])
         {
-            button->_debounceTimer = this;
-            _buttonList[i] = button;
-            return true;
+            PRINTLN("    < ", (i < NumBucket - 1) ? (1UL << (i + 1)) : UINT32_MAX, "us: ", _bucket[i]);
         }
     }
-    return false;
 }
 
-bool DebounceTimer::detachButton(DebounceButton *button)
+void ClickLatency::reset(void)
 {
-    for (int i = 0; i < ButtonListSize; i++)
-    {
-        if (_buttonList[i] == button)
-        {
-            _buttonList[i] = nullptr;
-            return true;
-        }
-    }
-    return false;
+    isrToQueueMain.reset();
+    isrToThreadGame.reset();
+    isrToPosition.reset();
+    isrToShow.reset();
 }
 
-void DebounceTimer::onEventTimer(void)
+void ClickLatency::print(void) const
 {
-    bool isDebounceActive = false;
-    for (int i = 0; i < ButtonListSize; i++)
-    {
-        DebounceButton *button = _buttonList[i];
-        if (button != nullptr && button->isDebounceActive())
-        {
-            button->onEventTimer();
-            isDebounceActive = true;
-        }
-    }
-
-    // stop/disable debounce timer if all debounce buttons are inactive
-    if (!isDebounceActive)
-    {
-        stop();
-    }
+    PRINTLN("===============================================================================");
+    isrToQueueMain.print("isr -> QueueMain");
+    isrToThreadGame.print("isr -> ThreadGame");
+    isrToPosition.print("isr -> position");
+    isrToShow.print("isr -> show");
+    PRINTLN("===============================================================================");
 }
@@ -0,0 +1,112 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <Arduino.h>
+
+/////////////////////////////////////////////////////////////////////////////
+// fixed-size latency histogram in unit of us
+// bucket[i] counts samples in [2^i, 2^(i+1)) us, the last bucket also holds anything longer
+/////////////////////////////////////////////////////////////////////////////
+class LatencyHistogram
+{
+public:
+    static constexpr uint8_t NumBucket = 20; // last bucket starts at 2^19 us (~524ms)
+
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    void reset(void)
+    {
+        memset(_bucket, 0, sizeof(_bucket));
+        _count = 0;
+        _sum = 0;
+        _min = UINT32_MAX;
+        _max = 0;
+    }
+
+    void add(uint32_t us)
+    {
+        uint8_t index = (us > 1) ? (31 - __builtin_clz(us)) : 0;
+        if (index >= NumBucket)
+        {
+            index = NumBucket - 1;
+        }
+        _bucket[index]++;
+        _count++;
+        _sum += us;
+        _min = (us < _min) ? us : _min;
+        _max = (us > _max) ? us : _max;
+    }
+
+    uint32_t count(void) const
+    {
+        return _count;
+    }
+    uint32_t min(void) const
+    {
+        return _count ? _min : 0;
+    }
+    uint32_t max(void) const
+    {
+        return _max;
+    }
+    uint32_t mean(void) const
+    {
+        return _count ? (uint32_t)(_sum / _count) : 0;
+    }
+    uint32_t bucket(uint8_t index) const
+    {
+        return index < NumBucket ? _bucket[index] : 0;
+    }
+
+    void print(const char *name) const;
+
+private:
+    uint32_t _bucket[NumBucket];
+    uint32_t _count;
+    uint64_t _sum;
+    uint32_t _min;
+    uint32_t _max;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// click-to-photon latency of a player button, all stages are measured from the GPIO ISR timestamp
+// each histogram is written by a single task only
+/////////////////////////////////////////////////////////////////////////////
+typedef struct _ClickLatency
+{
+    LatencyHistogram isrToQueueMain;  // GPIO ISR -> QueueMain::handlerEventGpioISR
+    LatencyHistogram isrToThreadGame; // GPIO ISR -> ThreadGame::handlerEventUser
+    LatencyHistogram isrToPosition;   // GPIO ISR -> ThreadGame::advancePlayerPosition done
+    LatencyHistogram isrToShow;       // GPIO ISR -> transmission of the frame drawing the click done (SysLedTxDone)
+
+    void reset(void);
+    void print(void) const;
+} ClickLatency;
+
+extern ClickLatency clickLatency;
+
+// elapsed us since an ISR timestamp taken by micros(), wrap-around safe
+static inline uint32_t elapsedUs(uint32_t since)
+{
+    return micros() - since;
+}
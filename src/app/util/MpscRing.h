@@ -0,0 +1,111 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/////////////////////////////////////////////////////////////////////////////
+// lock-free multi-producer / single-consumer ring buffer
+// each slot carries a sequence number: producers claim a slot by CAS on head, then publish it by
+// advancing the slot's sequence, so the consumer never sees a half-written item. N must be a power of 2
+/////////////////////////////////////////////////////////////////////////////
+template <typename T, uint32_t N>
+class MpscRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of 2");
+
+public:
+    MpscRing() : _head(0), _tail(0), _overflow(0)
+    {
+        for (uint32_t i = 0; i < N; i++)
+        {
+            _slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // producer side (any task or ISR), returns false (and counts an overflow) if the ring is full
+    bool push(const T &item)
+    {
+        uint32_t pos = _head.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;)
+        {
+            slot = &_slots[pos & (N - 1)];
+            int32_t diff = (int32_t)(slot->seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0)
+            {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                _overflow.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = _head.load(std::memory_order_relaxed);
+            }
+        }
+        slot->item = item;
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side, returns false if the ring is empty
+    bool pop(T &item)
+    {
+        Slot &slot = _slots[_tail & (N - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != _tail + 1)
+        {
+            return false;
+        }
+        item = slot.item;
+        slot.seq.store(_tail + N, std::memory_order_release);
+        _tail++;
+        return true;
+    }
+
+    static constexpr uint32_t capacity(void)
+    {
+        return N;
+    }
+
+    // number of items dropped because the ring was full
+    uint32_t overflow(void) const
+    {
+        return _overflow.load(std::memory_order_relaxed);
+    }
+
+private:
+    typedef struct _Slot
+    {
+        std::atomic<uint32_t> seq;
+        T item;
+    } Slot;
+
+    Slot _slots[N];
+    std::atomic<uint32_t> _head; // claimed by producers
+    uint32_t _tail;              // consumer only
+    std::atomic<uint32_t> _overflow;
+};
@@ -0,0 +1,87 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/////////////////////////////////////////////////////////////////////////////
+// lock-free single-producer / single-consumer ring buffer
+// the producer may run in ISR context, N must be a power of 2
+/////////////////////////////////////////////////////////////////////////////
+template <typename T, uint32_t N>
+class SpscRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of 2");
+
+public:
+    SpscRing() : _head(0), _tail(0), _overflow(0)
+    {
+    }
+
+    // producer side, returns false (and counts an overflow) if the ring is full
+    bool push(const T &item)
+    {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N)
+        {
+            _overflow.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _buffer[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side, returns false if the ring is empty
+    bool pop(T &item)
+    {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = _buffer[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t size(void) const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr uint32_t capacity(void)
+    {
+        return N;
+    }
+
+    // number of items dropped because the ring was full
+    uint32_t overflow(void) const
+    {
+        return _overflow.load(std::memory_order_relaxed);
+    }
+
+private:
+    T _buffer[N];
+    std::atomic<uint32_t> _head; // written by producer only
+    std::atomic<uint32_t> _tail; // written by consumer only
+    std::atomic<uint32_t> _overflow;
+};
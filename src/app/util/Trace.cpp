@@ -0,0 +1,136 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <stdio.h>
+#include "../ArduProfFreeRTOS.h"
+#include "./Trace.h"
+
+#define TASK_NAME "Trace"
+#define TASK_STACK_SIZE 2048
+#define TASK_PRIORITY 1                        // just above idle, never delays the game tasks
+
+Trace trace;
+
+static StackType_t xStack[TASK_STACK_SIZE];
+static StaticTask_t xTaskBuffer;
+
+// decode table, index = TraceId
+typedef struct _TraceFormat
+{
+    const char *name;
+    const char *arg0; // label of arg0, nullptr if unused
+    const char *arg1; // label of arg1, nullptr if unused
+} TraceFormat;
+
+static const TraceFormat traceFormat[TraceIdMax] = {
+    {"UserClick", "button", "timestamp"},
+    {"Gesture", "button", "gesture"},
+    {"GameState", "state", nullptr},
+    {"Overtake", "leader", "was"},
+    {"PlayerWin", "player", nullptr},
+    {"Trace", nullptr, "dropped"},
+};
+
+void Trace::start(void)
+{
+    _task = xTaskCreateStaticPinnedToCore(
+        [](void *instance)
+        { static_cast<Trace *>(instance)->drainLoop(); },
+        TASK_NAME,
+        TASK_STACK_SIZE,
+        this,
+        TASK_PRIORITY,
+        xStack,
+        &xTaskBuffer,
+        ARDUINO_RUNNING_CORE);
+}
+
+void Trace::drainLoop(void)
+{
+    uint32_t dropped = 0;
+    for (;;)
+    {
+        // cleared first: a record written from here on notifies again, so none is left behind
+        // when the task blocks (records written before start() are drained on the first pass)
+        _isDrainPending.store(false, std::memory_order_release);
+
+        TraceRecord record;
+        while (_ring.pop(record))
+        {
+            send(record);
+        }
+        if (getDropped() != dropped)
+        {
+            dropped = getDropped();
+            send(TraceRecord{(uint32_t)micros(), TraceDropped, 0, dropped});
+        }
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+// once per burst of records, from a task or an ISR
+void Trace::notifyDrain(void)
+{
+    TaskHandle_t task = _task.load(std::memory_order_acquire);
+    if (task == nullptr)
+    {
+        return; // not started yet, see drainLoop()
+    }
+    if (xPortInIsrContext())
+    {
+        BaseType_t isWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(task, &isWoken);
+        portYIELD_FROM_ISR(isWoken);
+    }
+    else
+    {
+        xTaskNotifyGive(task);
+    }
+}
+
+// one frame per record, written whole: Serial holds it in its TX buffer, it is not split by a log line
+void Trace::send(const TraceRecord &record)
+{
+    uint8_t frame[TRACE_FRAME_SIZE];
+    traceEncode(record, frame);
+    Serial.write(frame, sizeof(frame));
+}
+
+int traceToText(const TraceRecord &record, char *text, size_t size)
+{
+    if (record.id >= TraceIdMax)
+    {
+        return snprintf(text, size, "[%u] unknown trace id=%u", (unsigned)record.time, record.id);
+    }
+
+    const TraceFormat &format = traceFormat[record.id];
+    int length = snprintf(text, size, "[%u] %s", (unsigned)record.time, format.name);
+    const char *separator = ": ";
+    if (format.arg0 && length >= 0 && (size_t)length < size)
+    {
+        length += snprintf(text + length, size - length, "%s%s=%u", separator, format.arg0, record.arg0);
+        separator = ", ";
+    }
+    if (format.arg1 && length >= 0 && (size_t)length < size)
+    {
+        length += snprintf(text + length, size - length, "%s%s=%u", separator, format.arg1, (unsigned)record.arg1);
+    }
+    return length;
+}
@@ -0,0 +1,144 @@
+/* Copyright 2024 teamprof.net@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify,
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+#include <atomic>
+#include <Arduino.h>
+#include "../AppConfig.h"
+#include "./MpscRing.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// binary trace of hot paths
+// TRACE() stores an id and two raw arguments into a lock-free ring and returns: no formatting nor UART I/O
+// on the caller's path. a low-priority task drains the ring and writes each record raw to Serial, between
+// the lines of the log; nothing is formatted on the target. it sleeps on a task notification, given by the
+// first record written after it went to sleep. compiled out unless APP_TRACE is defined in AppConfig.h
+//
+// the host tool host/tools/trace_decode.cpp turns the output of Serial back into text with traceToText()
+//
+// usage:
+//   TRACE(TraceUserClick, id, timestamp);
+/////////////////////////////////////////////////////////////////////////////
+typedef enum _TraceId : uint16_t
+{
+    TraceUserClick = 0, // arg0=<ButtonId>, arg1=ISR timestamp
+    TraceGesture,       // arg0=<ButtonId>, arg1=<UserTriggerSource>
+    TraceGameState,     // arg0=<GameState>, arg1=0
+    TraceOvertake,      // arg0=leader <GamePlayer>, arg1=previous leader
+    TracePlayerWin,     // arg0=<GamePlayer>, arg1=0
+    TraceDropped,       // arg0=0, arg1=records dropped since boot, written by the drain task
+    TraceIdMax,
+} TraceId;
+
+typedef struct _TraceRecord
+{
+    uint32_t time; // micros()
+    uint16_t id;   // TraceId
+    uint16_t arg0;
+    uint32_t arg1;
+} TraceRecord;
+
+#define TRACE_RING_SIZE 128 // must be a power of 2
+
+// a record on Serial: TRACE_FRAME_SYNC, then time, id, arg0 and arg1 little endian.
+// the sync byte is not ASCII, so it never occurs in the text of the log around the frames
+#define TRACE_FRAME_SYNC 0xA5
+#define TRACE_FRAME_SIZE 13
+
+static inline void traceEncode(const TraceRecord &record, uint8_t *frame)
+{
+    frame[0] = TRACE_FRAME_SYNC;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        frame[1 + i] = (uint8_t)(record.time >> (8 * i));
+        frame[9 + i] = (uint8_t)(record.arg1 >> (8 * i));
+    }
+    frame[5] = (uint8_t)record.id;
+    frame[6] = (uint8_t)(record.id >> 8);
+    frame[7] = (uint8_t)record.arg0;
+    frame[8] = (uint8_t)(record.arg0 >> 8);
+}
+
+// frame: TRACE_FRAME_SIZE bytes, returns false if it does not start with TRACE_FRAME_SYNC
+static inline bool traceDecode(const uint8_t *frame, TraceRecord &record)
+{
+    if (frame[0] != TRACE_FRAME_SYNC)
+    {
+        return false;
+    }
+    record.time = 0;
+    record.arg1 = 0;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        record.time |= (uint32_t)frame[1 + i] << (8 * i);
+        record.arg1 |= (uint32_t)frame[9 + i] << (8 * i);
+    }
+    record.id = (uint16_t)(frame[5] | (frame[6] << 8));
+    record.arg0 = (uint16_t)(frame[7] | (frame[8] << 8));
+    return true;
+}
+
+// text of a record with the decode table in Trace.cpp, e.g. "[605000] UserClick: button=2, timestamp=604000"
+// returns the length as snprintf(); for the host decoder, the target does not format records
+int traceToText(const TraceRecord &record, char *text, size_t size);
+
+class Trace
+{
+public:
+    Trace() : _task(nullptr), _isDrainPending(false)
+    {
+    }
+
+    void start(void); // create the drain task
+
+    bool write(TraceId id, uint16_t arg0, uint32_t arg1)
+    {
+        if (!_ring.push(TraceRecord{(uint32_t)micros(), id, arg0, arg1}))
+        {
+            return false;
+        }
+        if (!_isDrainPending.exchange(true, std::memory_order_acq_rel))
+        {
+            notifyDrain();
+        }
+        return true;
+    }
+
+    uint32_t getDropped(void) const
+    {
+        return _ring.overflow();
+    }
+
+private:
+    void drainLoop(void);
+    void notifyDrain(void);
+    void send(const TraceRecord &record);
+
+    MpscRing<TraceRecord, TRACE_RING_SIZE> _ring;
+    std::atomic<TaskHandle_t> _task; // drain task, nullptr until start()
+    std::atomic<bool> _isDrainPending; // the drain task is notified or draining, cleared before it drains
+};
+
+extern Trace trace;
+
+#ifdef APP_TRACE
+#define TRACE(id, arg0, arg1) trace.write((id), (uint16_t)(arg0), (uint32_t)(arg1))
+#else
+#define TRACE(id, arg0, arg1) ((void)0)
+#endif